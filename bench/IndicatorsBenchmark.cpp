@@ -0,0 +1,242 @@
+/*
+	Copyright (c) 2019 Maciej Goncerz <https://github.com/Paurin1>.
+	Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+	Compares kernels of Indicators.h with naive loops computing the same
+	values: every window summed or scanned again from scratch. Prints time
+	per input value of both and the largest relative difference between
+	their results. Build command is in README.md.
+
+	Usage: indicators_benchmark [number of values, 1000000 by default]
+*/
+
+#include <cstdio>		// printf
+#include <cstdlib>		// strtoul
+#include <cmath>		// sqrt, fabs, isnan
+#include <vector>		// vector
+#include <random>		// mt19937_64, normal_distribution
+#include <chrono>		// steady_clock
+#include <algorithm>	// max, min
+#include <functional>	// function
+
+#include "Indicators.h"
+
+namespace
+{
+	// every measurement is repeated and the fastest run is reported
+	const int repetitions = 5;
+
+	/**
+		Returns nanoseconds per value of the fastest of repeated runs
+	*/
+	double measure(size_t _count, const std::function<void()>& _run)
+	{
+		double _best = 0;
+
+		for (int i = 0; i < repetitions; ++i)
+		{
+			auto _start = std::chrono::steady_clock::now();
+			_run();
+			double _elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - _start).count();
+
+			if (i == 0 || _elapsed < _best)
+				_best = _elapsed;
+		}
+
+		return _best / _count;
+	}
+
+	/**
+		Largest relative difference of two results, NaN only matches NaN
+	*/
+	double difference(const std::vector<double>& _a, const std::vector<double>& _b)
+	{
+		double _largest = 0;
+
+		for (size_t i = 0; i < _a.size(); ++i)
+		{
+			if (std::isnan(_a[i]) || std::isnan(_b[i]))
+			{
+				if (std::isnan(_a[i]) != std::isnan(_b[i]))
+					return 1;
+
+				continue;
+			}
+
+			double _scale = std::max(std::fabs(_b[i]), 1e-300);
+			_largest = std::max(_largest, std::fabs(_a[i] - _b[i]) / _scale);
+		}
+
+		return _largest;
+	}
+
+	void report(const char* _name, double _kernel, double _naive, double _difference)
+	{
+		std::printf("%-22s %10.2f %10.2f %9.1fx %12.2e\n", _name, _kernel, _naive, _naive / _kernel, _difference);
+	}
+
+	/*
+		Naive loops, every window computed from scratch
+	*/
+
+	void naiveMovingAverage(const double* _values, size_t _count, size_t _period, double* _result)
+	{
+		for (size_t i = 0; i < _count; ++i)
+		{
+			if (i + 1 < _period)
+			{
+				_result[i] = NAN;
+				continue;
+			}
+
+			double _sum = 0;
+			for (size_t j = i + 1 - _period; j <= i; ++j)
+				_sum += _values[j];
+
+			_result[i] = _sum / _period;
+		}
+	}
+
+	void naiveRollingMaximum(const double* _values, size_t _count, size_t _period, double* _result)
+	{
+		for (size_t i = 0; i < _count; ++i)
+		{
+			if (i + 1 < _period)
+			{
+				_result[i] = NAN;
+				continue;
+			}
+
+			double _maximum = _values[i + 1 - _period];
+			for (size_t j = i + 2 - _period; j <= i; ++j)
+				_maximum = std::max(_maximum, _values[j]);
+
+			_result[i] = _maximum;
+		}
+	}
+
+	void naiveRollingMinimum(const double* _values, size_t _count, size_t _period, double* _result)
+	{
+		for (size_t i = 0; i < _count; ++i)
+		{
+			if (i + 1 < _period)
+			{
+				_result[i] = NAN;
+				continue;
+			}
+
+			double _minimum = _values[i + 1 - _period];
+			for (size_t j = i + 2 - _period; j <= i; ++j)
+				_minimum = std::min(_minimum, _values[j]);
+
+			_result[i] = _minimum;
+		}
+	}
+
+	void naiveRollingDeviation(const double* _values, size_t _count, size_t _period, double* _result)
+	{
+		for (size_t i = 0; i < _count; ++i)
+		{
+			if (i + 1 < _period)
+			{
+				_result[i] = NAN;
+				continue;
+			}
+
+			double _sum = 0;
+			for (size_t j = i + 1 - _period; j <= i; ++j)
+				_sum += _values[j];
+
+			double _mean = _sum / _period;
+			double _squares = 0;
+
+			for (size_t j = i + 1 - _period; j <= i; ++j)
+				_squares += (_values[j] - _mean) * (_values[j] - _mean);
+
+			_result[i] = std::sqrt(_squares / _period);
+		}
+	}
+
+	double naiveVwap(const double* _prices, const double* _volumes, size_t _count)
+	{
+		double _value = 0;
+		double _volume = 0;
+
+		for (size_t i = 0; i < _count; ++i)
+		{
+			_value += _prices[i] * _volumes[i];
+			_volume += _volumes[i];
+		}
+
+		return _volume > 0 ? _value / _volume : NAN;
+	}
+}
+
+int main(int _argc, char** _argv)
+{
+	size_t _count = _argc > 1 ? std::strtoul(_argv[1], nullptr, 10) : 1000000;
+
+	if (_count < 1000)
+		_count = 1000;
+
+	// random walk of prices and random volumes, like close and vol columns of a graph
+	std::mt19937_64 _random(42);
+	std::normal_distribution<double> _step(0, 1);
+	std::uniform_real_distribution<double> _amount(0.01, 5);
+
+	std::vector<double> _prices(_count);
+	std::vector<double> _volumes(_count);
+	double _price = 40000;
+
+	for (size_t i = 0; i < _count; ++i)
+	{
+		_price = std::max(1.0, _price + _step(_random) * 20);
+		_prices[i] = _price;
+		_volumes[i] = _amount(_random);
+	}
+
+	std::vector<double> _kernel(_count);
+	std::vector<double> _naive(_count);
+
+	std::printf("%zu values, %s kernels\n\n", _count, indicatorsImplementation().c_str());
+	std::printf("%-22s %10s %10s %10s %12s\n", "ns per value", "kernel", "naive", "speedup", "difference");
+
+	const size_t _periods[] = { 20, 200 };
+
+	for (size_t _period : _periods)
+	{
+		char _name[32];
+
+		double _fast = measure(_count, [&]() { movingAverage(_prices.data(), _count, _period, _kernel.data()); });
+		double _slow = measure(_count, [&]() { naiveMovingAverage(_prices.data(), _count, _period, _naive.data()); });
+		std::snprintf(_name, sizeof(_name), "SMA(%zu)", _period);
+		report(_name, _fast, _slow, difference(_kernel, _naive));
+
+		_fast = measure(_count, [&]() { rollingMaximum(_prices.data(), _count, _period, _kernel.data()); });
+		_slow = measure(_count, [&]() { naiveRollingMaximum(_prices.data(), _count, _period, _naive.data()); });
+		std::snprintf(_name, sizeof(_name), "rolling max(%zu)", _period);
+		report(_name, _fast, _slow, difference(_kernel, _naive));
+
+		_fast = measure(_count, [&]() { rollingMinimum(_prices.data(), _count, _period, _kernel.data()); });
+		_slow = measure(_count, [&]() { naiveRollingMinimum(_prices.data(), _count, _period, _naive.data()); });
+		std::snprintf(_name, sizeof(_name), "rolling min(%zu)", _period);
+		report(_name, _fast, _slow, difference(_kernel, _naive));
+
+		_fast = measure(_count, [&]() { rollingDeviation(_prices.data(), _count, _period, _kernel.data()); });
+		_slow = measure(_count, [&]() { naiveRollingDeviation(_prices.data(), _count, _period, _naive.data()); });
+		std::snprintf(_name, sizeof(_name), "rolling stddev(%zu)", _period);
+		report(_name, _fast, _slow, difference(_kernel, _naive));
+	}
+
+	// results are kept in volatile so the calls can't be dropped
+	volatile double _sink = 0;
+	double _fastVwap = 0;
+	double _slowVwap = 0;
+
+	double _fast = measure(_count, [&]() { _fastVwap = vwap(_prices.data(), _volumes.data(), _count); _sink = _fastVwap; });
+	double _slow = measure(_count, [&]() { _slowVwap = naiveVwap(_prices.data(), _volumes.data(), _count); _sink = _slowVwap; });
+	report("VWAP", _fast, _slow, std::fabs(_fastVwap - _slowVwap) / std::fabs(_slowVwap));
+
+	(void)_sink;
+	return 0;
+}
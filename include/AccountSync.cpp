@@ -0,0 +1,315 @@
+/*
+	Copyright (c) 2019 Maciej Goncerz <https://github.com/Paurin1>.
+	Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+	More detailed descriptions are in AccountSync.h file.
+*/
+
+#include "AccountSync.h"
+
+#include <algorithm>	// min, max
+#include <fstream>		// ifstream, ofstream
+#include <cstdio>		// rename, remove
+
+namespace
+{
+	// the most rows history and trades return at once
+	const long page_rows = 1000;
+
+	// a page is queued again after a failure, then the list is left for the next sync
+	const int max_attempts = 3;
+
+	const char* kind_name(AccountSync::e_kind _kind)
+	{
+		return _kind == AccountSync::e_history ? "history" : "trades";
+	}
+
+	// id of a row, -1 if it has none
+	long row_id(const nlohmann::json& _row)
+	{
+		auto _id = _row.find("id");
+
+		return _id != _row.end() && _id->is_number_integer() ? _id->get<long>() : -1;
+	}
+}
+
+AccountSync::AccountSync(PrivateCommandDispatcher& _dispatcher, std::string _directory) :
+	m_dispatcher(_dispatcher), m_directory(std::move(_directory)), m_pending(0)
+{
+	// one "kind key total" line per list
+	std::ifstream _file(m_directory + "/sync.state");
+	std::string _kind, _key;
+	long _total;
+
+	while (_file >> _kind >> _key >> _total)
+		m_totals[_kind + " " + _key] = _total;
+}
+
+void AccountSync::addHistory(std::string _currency)
+{
+	f_add(e_history, std::move(_currency));
+}
+
+void AccountSync::addTrades(std::string _market)
+{
+	f_add(e_trades, std::move(_market));
+}
+
+std::string AccountSync::path(e_kind _kind, const std::string& _key) const
+{
+	return m_directory + "/" + kind_name(_kind) + "-" + _key + ".jsonl";
+}
+
+std::vector<AccountSync::s_streamReport> AccountSync::sync()
+{
+	std::unique_lock<std::mutex> _lock(m_mutex);
+
+	// every list starts with its first page, which tells how many rows there are now
+	for (size_t i = 0; i < m_streams.size(); ++i)
+	{
+		s_stream& _stream = m_streams[i];
+
+		if (!_stream.loaded)
+			f_load(_stream);
+
+		_stream.reported = -1;
+		_stream.newestFirst = true;
+		_stream.low = 0;
+		_stream.high = page_rows;
+		_stream.edgeKnown = false;
+		_stream.pending = 0;
+		_stream.failed = false;
+		_stream.added = 0;
+		_stream.requests = 0;
+		_stream.synced.clear();
+
+		f_page(i, 0, 0);
+	}
+
+	m_condition.wait(_lock, [this]() { return m_pending == 0; });
+
+	std::vector<s_streamReport> _reports;
+	_reports.reserve(m_streams.size());
+
+	for (s_stream& _stream : m_streams)
+	{
+		bool _success = !_stream.failed && _stream.reported >= 0;
+
+		// a list that failed keeps the old total, so its new rows are looked for again next time
+		if (_success)
+		{
+			_stream.total = _stream.reported;
+			m_totals[std::string(kind_name(_stream.kind)) + " " + _stream.key] = _stream.total;
+		}
+
+		_reports.push_back({ _stream.kind, _stream.key, _stream.reported, _stream.added, _stream.requests, _success });
+	}
+
+	f_saveState();
+
+	return _reports;
+}
+
+void AccountSync::f_add(e_kind _kind, std::string _key)
+{
+	std::lock_guard<std::mutex> _lock(m_mutex);
+
+	s_stream _stream = s_stream();
+	_stream.kind = _kind;
+	_stream.key = std::move(_key);
+
+	m_streams.push_back(std::move(_stream));
+}
+
+void AccountSync::f_load(s_stream& _stream)
+{
+	auto _total = m_totals.find(std::string(kind_name(_stream.kind)) + " " + _stream.key);
+	_stream.total = _total != m_totals.end() ? _total->second : 0;
+
+	std::ifstream _file(path(_stream.kind, _stream.key));
+	std::string _line;
+
+	while (std::getline(_file, _line))
+	{
+		// a line cut short by a crash is skipped, its row is downloaded again
+		nlohmann::json _row = nlohmann::json::parse(_line, nullptr, false);
+
+		long _id = _row.is_discarded() ? -1 : row_id(_row);
+		if (_id >= 0)
+			_stream.ids.insert(_id);
+	}
+
+	_stream.loaded = true;
+}
+
+void AccountSync::f_page(size_t _index, long _start, int _attempt)
+{
+	s_stream& _stream = m_streams[_index];
+
+	++_stream.pending;
+	++_stream.requests;
+	++m_pending;
+
+	std::unordered_map<std::string, std::string> _arguments;
+	_arguments[_stream.kind == e_history ? "currency" : "market"] = _stream.key;
+	_arguments["count"] = std::to_string(page_rows);
+	_arguments["start"] = std::to_string(_start);
+
+	m_dispatcher.submit([this, _index, _start, _attempt](ptr_json _response)
+	{
+		f_response(_index, _start, _attempt, _response);
+	}, kind_name(_stream.kind), std::move(_arguments));
+}
+
+void AccountSync::f_response(size_t _index, long _start, int _attempt, ptr_json _response)
+{
+	std::unique_lock<std::mutex> _lock(m_mutex);
+	s_stream& _stream = m_streams[_index];
+
+	// responses look like {"success":true,"data":{"total":..,"start":..,"count":..,"results":[...]}}
+	const nlohmann::json* _data = nullptr;
+
+	if (_response && _response->is_object())
+	{
+		auto _found = _response->find("data");
+		if (_found != _response->end() && _found->is_object() && _found->count("results") && (*_found)["results"].is_array())
+			_data = &*_found;
+	}
+
+	if (!_data)
+	{
+		if (_attempt + 1 < max_attempts)
+			f_page(_index, _start, _attempt + 1);
+		else
+			_stream.failed = true;
+	}
+	else
+	{
+		const nlohmann::json& _results = (*_data)["results"];
+
+		if (_stream.reported < 0)
+			f_plan(_stream, _index, *_data);
+
+		// the row at the far end of requested range shows whether it reaches rows stored before
+		long _edge = _stream.newestFirst ? _stream.high - 1 : _stream.low;
+
+		std::ofstream _file;
+
+		for (size_t i = 0; i < _results.size(); ++i)
+		{
+			const nlohmann::json& _row = _results[i];
+			long _id = row_id(_row);
+			bool _stored = _id >= 0 && _stream.ids.count(_id);
+
+			if (_start + static_cast<long>(i) == _edge)
+				_stream.edgeKnown = _stored && !_stream.synced.count(_id);
+
+			if (_stored)
+				continue;
+
+			if (!_file.is_open())
+				_file.open(path(_stream.kind, _stream.key), std::ios::app);
+
+			_file << _row.dump() << '\n';
+
+			if (_id >= 0)
+			{
+				_stream.ids.insert(_id);
+				_stream.synced.insert(_id);
+			}
+
+			++_stream.added;
+		}
+
+		// rows are in the file before the page counts as done
+		if (_file.is_open())
+			_file.flush();
+	}
+
+	--_stream.pending;
+
+	// every requested page is in, the range is widened until it reaches a stored row or the end of the list
+	if (!_stream.pending && !_stream.failed && _stream.reported >= 0)
+	{
+		if (_stream.newestFirst && _stream.high < _stream.reported && !_stream.edgeKnown)
+		{
+			f_page(_index, _stream.high, 0);
+			_stream.high += page_rows;
+		}
+		else if (!_stream.newestFirst && _stream.low > 0 && !_stream.edgeKnown)
+		{
+			_stream.low = std::max(_stream.low - page_rows, 0L);
+			f_page(_index, _stream.low, 0);
+		}
+	}
+
+	if (--m_pending == 0)
+		m_condition.notify_all();
+}
+
+void AccountSync::f_plan(s_stream& _stream, size_t _index, const nlohmann::json& _data)
+{
+	const nlohmann::json& _results = _data["results"];
+
+	auto _total = _data.find("total");
+	_stream.reported = _total != _data.end() && _total->is_number_integer() ? _total->get<long>() : static_cast<long>(_results.size());
+
+	long _new = _stream.reported - _stream.total;
+
+	// ids grow with time, so they tell the order of the list
+	if (_results.size() >= 2)
+	{
+		long _first = row_id(_results[0]);
+		long _last = row_id(_results[_results.size() - 1]);
+
+		_stream.newestFirst = _first < 0 || _last < 0 || _first > _last;
+	}
+
+	if (_stream.newestFirst)
+	{
+		// new rows take positions below _new, the page holding position _new reaches stored ones
+		_stream.low = 0;
+		_stream.high = page_rows;
+
+		for (long _start = page_rows; _start <= _new && _start < _stream.reported; _start += page_rows)
+		{
+			f_page(_index, _start, 0);
+			_stream.high = _start + page_rows;
+		}
+	}
+	else
+	{
+		// new rows follow the stored ones, pages start at the last stored row (or the last row, if some were removed)
+		_stream.low = std::max(std::min(_stream.total, _stream.reported) - 1, 0L);
+		_stream.high = _stream.reported;
+
+		for (long _start = _stream.low; _start < _stream.reported; _start += page_rows)
+			f_page(_index, _start, 0);
+	}
+}
+
+void AccountSync::f_saveState()
+{
+	// written aside and renamed over the old file, so a crash never leaves half of it
+	std::string _path = m_directory + "/sync.state";
+	std::string _temporary = _path + ".tmp";
+
+	{
+		std::ofstream _file(_temporary, std::ios::trunc);
+		if (!_file)
+			return;
+
+		for (const auto& _total : m_totals)
+			_file << _total.first << ' ' << _total.second << '\n';
+
+		if (!_file.flush())
+			return;
+	}
+
+	// rename doesn't replace an existing file on Windows
+	if (std::rename(_temporary.c_str(), _path.c_str()) != 0)
+	{
+		std::remove(_path.c_str());
+		std::rename(_temporary.c_str(), _path.c_str());
+	}
+}
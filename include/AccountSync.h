@@ -0,0 +1,148 @@
+/*
+	Copyright (c) 2019 Maciej Goncerz <https://github.com/Paurin1>.
+	Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+	AccountSync class keeps a local copy of account's history of operations
+	and trades, downloading only rows added since the previous sync.
+
+	history and trades commands return lists of up to 1000 rows with the
+	number of all rows in "total". Total known from the last sync tells how
+	many rows are new and so which pages hold them. Pages of every currency
+	and market are queued in PrivateCommandDispatcher at once, the limit
+	of commands paces them and more urgent commands overtake them. Rows are
+	told apart by id: the page after the new rows has to contain a row that
+	is already stored, otherwise (rows were removed from the list) further
+	pages are fetched until it does. Lists ordered from the newest row get
+	new rows at the front, lists ordered from the oldest at the back, which
+	order a list has is seen from ids of its first page.
+
+	Rows are appended to one JSON Lines file per currency or market in the
+	store directory as pages arrive, each row once, in order of arrival.
+	Totals are written to "sync.state" in the same directory when sync()
+	finishes, a sync that has been interrupted is simply repeated.
+*/
+
+#ifndef ACCOUNTSYNC_H
+#define ACCOUNTSYNC_H
+
+#include <string>				// string
+#include <vector>				// vector
+#include <map>					// map
+#include <unordered_set>		// unordered_set
+#include <mutex>				// mutex, unique_lock
+#include <condition_variable>	// condition_variable
+
+// Queue the commands are sent through
+#include "PrivateCommandDispatcher.h"
+
+class AccountSync
+{
+public:
+	enum e_kind
+	{
+		e_history,	// history of operations in a currency
+		e_trades	// trades on a market
+	};
+
+	/**
+		Result of one list's sync
+	*/
+	struct s_streamReport
+	{
+		e_kind kind;
+		std::string key;	// currency or market
+		long total;			// number of rows reported by the API
+		long added;			// number of rows new to the store
+		long requests;
+		bool success;		// false if some page couldn't be obtained, the list is synced again next time
+	};
+
+	/**
+		@param _dispatcher queue the commands are sent through, must outlive the object
+		@param _directory existing directory of the store, files are created in it as needed
+	*/
+	AccountSync(PrivateCommandDispatcher& _dispatcher, std::string _directory);
+
+	AccountSync(const AccountSync&) = delete;
+	AccountSync& operator=(const AccountSync&) = delete;
+
+	/**
+		Adds history of operations in given currency to the synced lists
+	*/
+	void addHistory(std::string _currency);
+
+	/**
+		Adds trades on given market to the synced lists
+	*/
+	void addTrades(std::string _market);
+
+	/**
+		Downloads new rows of every list, blocks until all are done. Only one sync may run at a time
+
+		@return report of every list in order of adding
+	*/
+	std::vector<s_streamReport> sync();
+
+	/**
+		Returns path of the file rows of given list are stored in
+	*/
+	std::string path(e_kind _kind, const std::string& _key) const;
+
+private:
+	struct s_stream
+	{
+		e_kind kind;
+		std::string key;
+		long total;						// rows in the list as of the last complete sync
+		std::unordered_set<long> ids;	// ids of stored rows
+		bool loaded;
+
+		// state of the sync in progress
+		long reported;			// total reported in this sync
+		bool newestFirst;		// order of the list, rows are added at its front
+		long low;				// range of positions requested
+		long high;
+		bool edgeKnown;			// the row at the far end of the range is a stored one
+		size_t pending;
+		bool failed;
+		long added;
+		long requests;
+		std::unordered_set<long> synced;	// ids stored by this sync
+	};
+
+	void f_add(e_kind _kind, std::string _key);
+
+	/**
+		Reads ids of stored rows
+	*/
+	void f_load(s_stream& _stream);
+
+	/**
+		Queues one page of the list, m_mutex must be locked
+	*/
+	void f_page(size_t _index, long _start, int _attempt);
+
+	/**
+		Stores rows of a page and queues pages that follow from it, called from executor's thread
+	*/
+	void f_response(size_t _index, long _start, int _attempt, ptr_json _response);
+
+	/**
+		Plans pages holding the new rows once the first page tells the total
+	*/
+	void f_plan(s_stream& _stream, size_t _index, const nlohmann::json& _data);
+
+	void f_saveState();
+
+	PrivateCommandDispatcher& m_dispatcher;
+	std::string m_directory;
+
+	std::vector<s_stream> m_streams;
+	std::map<std::string, long> m_totals;	// "kind key" read from sync.state
+
+	size_t m_pending;
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+};
+
+#endif
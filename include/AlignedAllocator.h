@@ -0,0 +1,78 @@
+/*
+	Copyright (c) 2019 Maciej Goncerz <https://github.com/Paurin1>.
+	Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+	AlignedAllocator is an allocator for standard containers whose memory
+	starts at a multiple of given alignment, 64 bytes by default: a cache
+	line and the width of AVX-512 registers. Vectorised loops over such
+	arrays may use aligned loads.
+*/
+
+#ifndef ALIGNEDALLOCATOR_H
+#define ALIGNEDALLOCATOR_H
+
+#include <cstddef>	// size_t
+#include <cstdlib>	// free
+#include <new>		// bad_alloc
+
+#ifdef _WIN32
+#include <malloc.h>	// _aligned_malloc, _aligned_free
+#endif
+
+template <typename T, size_t Alignment = 64>
+class AlignedAllocator
+{
+public:
+	typedef T value_type;
+
+	template <typename U>
+	struct rebind
+	{
+		typedef AlignedAllocator<U, Alignment> other;
+	};
+
+	AlignedAllocator() noexcept { }
+
+	template <typename U>
+	AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept { }
+
+	T* allocate(size_t _count)
+	{
+		if (_count == 0)
+			return nullptr;
+
+		if (_count > static_cast<size_t>(-1) / sizeof(T))
+			throw std::bad_alloc();
+
+		void* _memory = nullptr;
+
+#ifdef _WIN32
+		_memory = _aligned_malloc(_count * sizeof(T), Alignment);
+#else
+		if (posix_memalign(&_memory, Alignment, _count * sizeof(T)) != 0)
+			_memory = nullptr;
+#endif
+
+		if (!_memory)
+			throw std::bad_alloc();
+
+		return static_cast<T*>(_memory);
+	}
+
+	void deallocate(T* _memory, size_t) noexcept
+	{
+#ifdef _WIN32
+		_aligned_free(_memory);
+#else
+		std::free(_memory);
+#endif
+	}
+
+	template <typename U>
+	bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept { return true; }
+
+	template <typename U>
+	bool operator!=(const AlignedAllocator<U, Alignment>&) const noexcept { return false; }
+};
+
+#endif
@@ -0,0 +1,400 @@
+/*
+	Copyright (c) 2019 Maciej Goncerz <https://github.com/Paurin1>.
+	Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+	BitmarketCoroutines.h file contains C++20 coroutine support for
+	BitmarketPublic and BitmarketPrivate. Requests are started through
+	their asynchronous (...Async) methods and the awaiting coroutine is
+	resumed on an EventLoop, so many requests can be awaited one after
+	another without nested callbacks and without a thread per request.
+
+	Unlike the rest of the project this file requires C++20.
+
+	Example:
+
+		Task<void> requote(AwaitablePrivate& _private, int _id)
+		{
+			co_await _private.cancel(_id);
+			co_await _private.trade("BTCPLN", "buy", 0.01, 30000.0, false);
+		}
+
+		EventLoop loop;
+		AwaitablePrivate awaitable(bitPrv, loop);
+		runTask(loop, requote(awaitable, 1234));
+*/
+
+#ifndef BITMARKETCOROUTINES_H
+#define BITMARKETCOROUTINES_H
+
+#if !defined(__cpp_impl_coroutine)
+#error "BitmarketCoroutines.h requires C++20 coroutines, compile with -std=c++20"
+#endif
+
+#include <coroutine>	// coroutine_handle, suspend_always, noop_coroutine
+#include <exception>	// exception_ptr, rethrow_exception
+#include <optional>		// optional
+#include <utility>		// move
+#include <type_traits>	// is_void
+
+#include "EventLoop.h"
+#include "BitmarketPublic.h"
+#include "BitmarketPrivate.h"
+
+template <typename T>
+class Task;
+
+/**
+	Part of Task's promise that doesn't depend on the result type
+*/
+class TaskPromiseBase
+{
+public:
+	/**
+		Resumes the awaiting coroutine when the task has finished
+	*/
+	struct FinalAwaiter
+	{
+		bool await_ready() const noexcept { return false; }
+
+		template <typename T_promise>
+		std::coroutine_handle<> await_suspend(std::coroutine_handle<T_promise> _handle) noexcept
+		{
+			std::coroutine_handle<> _continuation = _handle.promise().m_continuation;
+			return _continuation ? _continuation : std::noop_coroutine();
+		}
+
+		void await_resume() const noexcept { }
+	};
+
+	// tasks are lazy, they start when awaited
+	std::suspend_always initial_suspend() const noexcept { return {}; }
+	FinalAwaiter final_suspend() const noexcept { return {}; }
+
+	void unhandled_exception() noexcept { m_error = std::current_exception(); }
+
+	std::coroutine_handle<> m_continuation;
+	std::exception_ptr m_error;
+};
+
+template <typename T>
+class TaskPromise : public TaskPromiseBase
+{
+public:
+	void return_value(T _value) { m_value = std::move(_value); }
+
+	T result()
+	{
+		if (m_error)
+			std::rethrow_exception(m_error);
+
+		return std::move(*m_value);
+	}
+
+private:
+	std::optional<T> m_value;
+};
+
+template <>
+class TaskPromise<void> : public TaskPromiseBase
+{
+public:
+	void return_void() const noexcept { }
+
+	void result()
+	{
+		if (m_error)
+			std::rethrow_exception(m_error);
+	}
+};
+
+/**
+	Lazily started coroutine returning T. Awaiting it starts the coroutine
+	and resumes the awaiting one when it finishes, exceptions are passed on.
+*/
+template <typename T>
+class Task
+{
+public:
+	struct promise_type : public TaskPromise<T>
+	{
+		Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+	};
+
+	Task(Task&& _other) noexcept : m_handle(_other.m_handle) { _other.m_handle = nullptr; }
+
+	Task& operator=(Task&& _other) noexcept
+	{
+		if (this != &_other)
+		{
+			if (m_handle)
+				m_handle.destroy();
+
+			m_handle = _other.m_handle;
+			_other.m_handle = nullptr;
+		}
+
+		return *this;
+	}
+
+	Task(const Task&) = delete;
+	Task& operator=(const Task&) = delete;
+
+	~Task()
+	{
+		if (m_handle)
+			m_handle.destroy();
+	}
+
+	bool await_ready() const noexcept { return !m_handle || m_handle.done(); }
+
+	std::coroutine_handle<> await_suspend(std::coroutine_handle<> _awaiting) noexcept
+	{
+		m_handle.promise().m_continuation = _awaiting;
+		return m_handle;
+	}
+
+	T await_resume() { return m_handle.promise().result(); }
+
+private:
+	explicit Task(std::coroutine_handle<promise_type> _handle) : m_handle(_handle) { }
+
+	std::coroutine_handle<promise_type> m_handle;
+};
+
+/**
+	Awaits a result delivered to a callback, i.e. by one of ...Async methods.
+	The callback may be called from any thread, the awaiting coroutine is
+	always resumed on the event loop.
+*/
+template <typename T>
+class CallbackAwaitable
+{
+public:
+	typedef std::function<void(std::function<void(T)>)> starter;
+
+	/**
+		@param _loop event loop the awaiting coroutine is resumed on
+		@param _start function starting the operation with given completion callback
+	*/
+	CallbackAwaitable(EventLoop& _loop, starter _start) : m_loop(_loop), m_start(std::move(_start)) { }
+
+	bool await_ready() const noexcept { return false; }
+
+	void await_suspend(std::coroutine_handle<> _handle)
+	{
+		m_start([this, _handle](T _result) {
+			m_result = std::move(_result);
+			m_loop.post([_handle]() { _handle.resume(); });
+		});
+	}
+
+	T await_resume() { return std::move(m_result); }
+
+private:
+	EventLoop& m_loop;
+	starter m_start;
+	T m_result;
+};
+
+/**
+	Suspends the awaiting coroutine for given time without blocking the loop
+*/
+class DelayAwaitable
+{
+public:
+	DelayAwaitable(EventLoop& _loop, std::chrono::milliseconds _delay) : m_loop(_loop), m_delay(_delay) { }
+
+	bool await_ready() const noexcept { return m_delay.count() <= 0; }
+
+	void await_suspend(std::coroutine_handle<> _handle)
+	{
+		m_loop.postAfter(m_delay, [_handle]() { _handle.resume(); });
+	}
+
+	void await_resume() const noexcept { }
+
+private:
+	EventLoop& m_loop;
+	std::chrono::milliseconds m_delay;
+};
+
+/**
+	Awaitable versions of BitmarketPublic methods
+*/
+class AwaitablePublic
+{
+public:
+	AwaitablePublic(BitmarketPublic& _public, EventLoop& _loop) : m_public(_public), m_loop(_loop) { }
+
+	CallbackAwaitable<std::shared_ptr<const s_ticker>> ticker(std::string _market = "BTCPLN")
+	{
+		BitmarketPublic& _public = m_public;
+		return { m_loop, [&_public, _market](std::function<void(std::shared_ptr<const s_ticker>)> _done) { _public.tickerAsync(_done, _market); } };
+	}
+
+	CallbackAwaitable<std::shared_ptr<const s_orderBook>> orderbook(std::string _market = "BTCPLN")
+	{
+		BitmarketPublic& _public = m_public;
+		return { m_loop, [&_public, _market](std::function<void(std::shared_ptr<const s_orderBook>)> _done) { _public.orderbookAsync(_done, _market); } };
+	}
+
+	CallbackAwaitable<std::shared_ptr<const s_trades>> trades(int _since = -1, std::string _market = "BTCPLN")
+	{
+		BitmarketPublic& _public = m_public;
+		return { m_loop, [&_public, _since, _market](std::function<void(std::shared_ptr<const s_trades>)> _done) { _public.tradesAsync(_done, _since, _market); } };
+	}
+
+	CallbackAwaitable<std::shared_ptr<const s_graph>> graphs(std::string _interval, std::string _market = "BTCPLN")
+	{
+		BitmarketPublic& _public = m_public;
+		return { m_loop, [&_public, _interval, _market](std::function<void(std::shared_ptr<const s_graph>)> _done) { _public.graphsAsync(_done, _interval, _market); } };
+	}
+
+	DelayAwaitable delay(std::chrono::milliseconds _delay) { return { m_loop, _delay }; }
+
+private:
+	BitmarketPublic& m_public;
+	EventLoop& m_loop;
+};
+
+/**
+	Awaitable versions of BitmarketPrivate methods
+*/
+class AwaitablePrivate
+{
+public:
+	AwaitablePrivate(BitmarketPrivate& _private, EventLoop& _loop) : m_private(_private), m_loop(_loop) { }
+
+	CallbackAwaitable<ptr_json> info()
+	{
+		BitmarketPrivate& _private = m_private;
+		return { m_loop, [&_private](json_callback _done) { _private.infoAsync(_done); } };
+	}
+
+	CallbackAwaitable<ptr_json> trade(std::string _market, std::string _type, double _amount, double _rate, bool _allOrNothing)
+	{
+		BitmarketPrivate& _private = m_private;
+		return { m_loop, [&_private, _market, _type, _amount, _rate, _allOrNothing](json_callback _done) {
+			_private.tradeAsync(_done, _market, _type, _amount, _rate, _allOrNothing);
+		} };
+	}
+
+	CallbackAwaitable<ptr_json> cancel(int _id)
+	{
+		BitmarketPrivate& _private = m_private;
+		return { m_loop, [&_private, _id](json_callback _done) { _private.cancelAsync(_done, _id); } };
+	}
+
+	CallbackAwaitable<ptr_json> orders(std::string _market)
+	{
+		BitmarketPrivate& _private = m_private;
+		return { m_loop, [&_private, _market](json_callback _done) { _private.ordersAsync(_done, _market); } };
+	}
+
+	CallbackAwaitable<ptr_json> trades(std::string _market, int _count, int _start)
+	{
+		BitmarketPrivate& _private = m_private;
+		return { m_loop, [&_private, _market, _count, _start](json_callback _done) { _private.tradesAsync(_done, _market, _count, _start); } };
+	}
+
+	CallbackAwaitable<ptr_json> history(std::string _currency, int _count, int _start)
+	{
+		BitmarketPrivate& _private = m_private;
+		return { m_loop, [&_private, _currency, _count, _start](json_callback _done) { _private.historyAsync(_done, _currency, _count, _start); } };
+	}
+
+	CallbackAwaitable<ptr_json> command(std::string _method, std::unordered_map<std::string, std::string> _arguments)
+	{
+		BitmarketPrivate& _private = m_private;
+		return { m_loop, [&_private, _method, _arguments](json_callback _done) { _private.commandAsync(_done, _method, _arguments); } };
+	}
+
+	DelayAwaitable delay(std::chrono::milliseconds _delay) { return { m_loop, _delay }; }
+
+private:
+	BitmarketPrivate& m_private;
+	EventLoop& m_loop;
+};
+
+namespace coroutine_detail
+{
+	/**
+		Eagerly started coroutine that destroys itself when finished
+	*/
+	struct DetachedTask
+	{
+		struct promise_type
+		{
+			DetachedTask get_return_object() const noexcept { return {}; }
+			std::suspend_never initial_suspend() const noexcept { return {}; }
+			std::suspend_never final_suspend() const noexcept { return {}; }
+			void return_void() const noexcept { }
+			void unhandled_exception() const noexcept { std::terminate(); }
+		};
+	};
+
+	template <typename T>
+	DetachedTask runAndStop(EventLoop& _loop, Task<T>& _task, std::optional<T>& _result, std::exception_ptr& _error)
+	{
+		try
+		{
+			_result.emplace(co_await _task);
+		}
+		catch (...)
+		{
+			_error = std::current_exception();
+		}
+
+		_loop.stop();
+	}
+
+	inline DetachedTask runAndStop(EventLoop& _loop, Task<void>& _task, std::exception_ptr& _error)
+	{
+		try
+		{
+			co_await _task;
+		}
+		catch (...)
+		{
+			_error = std::current_exception();
+		}
+
+		_loop.stop();
+	}
+}
+
+/**
+	Runs the event loop on the calling thread until given task has finished
+
+	@param _loop event loop the task's coroutines are resumed on
+	@param _task task to be run
+	@return value returned by the task, its exception is rethrown
+*/
+template <typename T>
+T runTask(EventLoop& _loop, Task<T> _task)
+{
+	std::exception_ptr _error;
+
+	if constexpr (std::is_void<T>::value)
+	{
+		_loop.post([&]() { coroutine_detail::runAndStop(_loop, _task, _error); });
+		_loop.run();
+
+		if (_error)
+			std::rethrow_exception(_error);
+	}
+	else
+	{
+		std::optional<T> _result;
+
+		_loop.post([&]() { coroutine_detail::runAndStop(_loop, _task, _result, _error); });
+		_loop.run();
+
+		if (_error)
+			std::rethrow_exception(_error);
+
+		return std::move(*_result);
+	}
+}
+
+#endif
@@ -12,11 +12,11 @@
 BitmarketPrivate::BitmarketPrivate() : BitmarketPrivate(std::string(), std::string())
 { }
 
-BitmarketPrivate::BitmarketPrivate(std::string _public, std::string _private) : key_private(_private), key_public(_public)
-{
-	m_pythonNet.m_pyFile = "bitmarket_python.py";
-	m_pythonNet.m_pyPath = "pythonScript";
+BitmarketPrivate::BitmarketPrivate(std::string _public, std::string _private) : BitmarketPrivate(_public, _private, HttpsConnectionPool::shared())
+{ }
 
+BitmarketPrivate::BitmarketPrivate(std::string _public, std::string _private, std::shared_ptr<HttpsConnectionPool> _pool) : key_public(_public), key_private(_private), m_httpsNet(_pool), m_executor(IoExecutor::shared())
+{
 	/*
 	m_errorCodes[500] = "Invalid HTTP method (other than POST)";
 	m_errorCodes[501] = "Invalid public key component";
@@ -71,16 +71,14 @@ ptr_json BitmarketPrivate::info()
 
 ptr_json BitmarketPrivate::trade(std::string _market, std::string _type, double _amount, double _rate, bool _allOrNothing)
 {
-	// declare variable to store arguments
-	std::unordered_map<std::string, std::string> arguments;
+	// std::to_string keeps only 6 digits after the point, amounts have 8
+	return this->trade(_market, _type, Decimal::fromDouble(_amount), Decimal::fromDouble(_rate), _allOrNothing);
+}
 
-	// store every argument in variable
-	// by using unordered_map we can easily store argument name and value
-	arguments["market"]			= _market;
-	arguments["type"]			= _type;
-	arguments["amount"]			= std::to_string(_amount);
-	arguments["rate"]			= std::to_string(_rate);
-	arguments["allOrNothing"]	= _allOrNothing ? "1" : "0";
+ptr_json BitmarketPrivate::trade(std::string _market, std::string _type, Decimal _amount, Decimal _rate, bool _allOrNothing)
+{
+	// declare variable to store arguments
+	std::unordered_map<std::string, std::string> arguments = f_tradeArguments(_market, _type, _amount, _rate, _allOrNothing);
 
 	// execute command and return it's return
 	return this->command("trade", arguments);
@@ -126,13 +124,104 @@ ptr_json BitmarketPrivate::history(std::string _currency, int _count, int _start
 	return this->command("history", arguments);
 }
 
+std::shared_ptr<s_accountInfo> BitmarketPrivate::infoTyped()
+{
+	std::unordered_map<std::string, std::string> arguments;
+
+	return commandTyped<s_accountInfo>("info", arguments);
+}
+
+std::shared_ptr<s_tradeResult> BitmarketPrivate::tradeTyped(std::string _market, std::string _type, Decimal _amount, Decimal _rate, bool _allOrNothing)
+{
+	std::unordered_map<std::string, std::string> arguments = f_tradeArguments(_market, _type, _amount, _rate, _allOrNothing);
+
+	return commandTyped<s_tradeResult>("trade", arguments);
+}
+
+std::shared_ptr<s_cancelResult> BitmarketPrivate::cancelTyped(int _id)
+{
+	std::unordered_map<std::string, std::string> arguments;
+
+	arguments["id"] = std::to_string(_id);
+
+	return commandTyped<s_cancelResult>("cancel", arguments);
+}
+
+std::shared_ptr<s_userOrders> BitmarketPrivate::ordersTyped(std::string _market)
+{
+	std::unordered_map<std::string, std::string> arguments;
+
+	arguments["market"] = _market;
+
+	return commandTyped<s_userOrders>("orders", arguments);
+}
+
+std::shared_ptr<s_userTrades> BitmarketPrivate::tradesTyped(std::string _market, int _count, int _start)
+{
+	std::unordered_map<std::string, std::string> arguments;
+
+	arguments["market"] = _market;
+	arguments["count"] = std::to_string(_count);
+	arguments["start"] = std::to_string(_start);
+
+	return commandTyped<s_userTrades>("trades", arguments);
+}
+
+std::shared_ptr<s_history> BitmarketPrivate::historyTyped(std::string _currency, int _count, int _start)
+{
+	std::unordered_map<std::string, std::string> arguments;
+
+	arguments["currency"] = _currency;
+	arguments["count"] = std::to_string(_count);
+	arguments["start"] = std::to_string(_start);
+
+	return commandTyped<s_history>("history", arguments);
+}
+
 void BitmarketPrivate::pythonPath(std::string _scriptName, std::string _path)
 {
-	m_pythonNet.m_pyFile = _scriptName;
-	m_pythonNet.m_pyPath = _path;
+	// python script is not used anymore, see HttpsNet
+	(void)_scriptName;
+	(void)_path;
+}
+
+ptr_json BitmarketPrivate::command(std::string _method, std::unordered_map<std::string, std::string>& _arguments, bool _reserved)
+{
+	return f_limited<nlohmann::json>(_method, _arguments, _reserved, [](const std::shared_ptr<ResponseBuffer>& _body)
+	{
+		// generate return data, parsed straight from transport's buffer
+		return std::make_shared<nlohmann::json>(nlohmann::json::parse(_body->data(), _body->data() + _body->size()));
+	});
+}
+
+template <typename Result>
+std::shared_ptr<Result> BitmarketPrivate::commandTyped(std::string _method, std::unordered_map<std::string, std::string>& _arguments, bool _reserved)
+{
+	return f_limited<Result>(_method, _arguments, _reserved, [](const std::shared_ptr<ResponseBuffer>& _body) -> std::shared_ptr<Result>
+	{
+		std::shared_ptr<Result> result = std::make_shared<Result>();
+
+		if (!parsePrivateResponse(_body->data(), _body->size(), *result))
+			return nullptr;
+
+		// the body stays with the result, it's parsed into JSON only if someone asks
+		result->json = JsonView(_body);
+
+		return result;
+	});
+}
+
+long BitmarketPrivate::remaining()
+{
+	return CommandLimiter::forKey(key_public)->remaining();
 }
 
-ptr_json BitmarketPrivate::command(std::string _method, std::unordered_map<std::string, std::string>& _arguments)
+std::shared_ptr<CommandLimiter> BitmarketPrivate::limiter()
+{
+	return CommandLimiter::forKey(key_public);
+}
+
+std::shared_ptr<ResponseBuffer> BitmarketPrivate::f_post(const std::string& _method, const std::unordered_map<std::string, std::string>& _arguments)
 {
 	// create data that is constant in every API request
 	std::string post = "method=" + _method + "&tonce=" + std::to_string(std::chrono::system_clock::to_time_t(std::chrono::system_clock::now()));
@@ -145,44 +234,305 @@ ptr_json BitmarketPrivate::command(std::string _method, std::unordered_map<std::
 	}
 
 	// calculate header values
-	headers += f_sha512(key_private, post);
+	char hash[128];
+	f_sha512(key_private, post, hash);
+	headers.append(hash, sizeof(hash));
 
-	// obtain response
-	std::string responseData = m_pythonNet.post("/api2/", post, headers);
+	std::shared_ptr<ResponseBuffer> responseData = m_httpsNet.postBuffer("/api2/", post, headers);
 
-	// if there was an error while calling python script then return nullptr
-	if (responseData.empty())
+	if (!responseData || responseData->empty())
 		return nullptr;
 
-	// generate return data
-	return std::shared_ptr<nlohmann::json>(new nlohmann::json(nlohmann::json::parse(responseData)));
+	return responseData;
 }
 
-std::string BitmarketPrivate::f_sha512(std::string _key, std::string _data)
+template <typename Result, typename Parse>
+std::shared_ptr<Result> BitmarketPrivate::f_limited(const std::string& _method, const std::unordered_map<std::string, std::string>& _arguments, bool _reserved, Parse _parse)
 {
-	// declare and define hash variable to store generated hash
-	unsigned char *hash = new unsigned char[64];
+	// the API counts commands per key, so every object using the key shares the limiter
+	std::shared_ptr<CommandLimiter> limiter = CommandLimiter::forKey(key_public);
 
-	// use CHMAC_SHA512 class to calculate hash
-	CHMAC_SHA512 hmac((const unsigned char*)_key.c_str(), _key.length());
-	hmac.Write((const unsigned char*)_data.c_str(), _data.length());
-	hmac.Finalize(hash);
+	// a command rejected with error 506 hasn't been executed, it's safe to send it again
+	for (int attempt = 0; ; ++attempt)
+	{
+		// wait until the limit allows to send the command
+		if (!_reserved || attempt > 0)
+			limiter->acquire();
+
+		std::shared_ptr<ResponseBuffer> responseData = f_post(_method, _arguments);
+
+		// if there was an error while sending the request then return nullptr
+		if (!responseData)
+			return nullptr;
+
+		std::shared_ptr<Result> response = _parse(responseData);
+
+		if (!response || !f_trackLimit(*limiter, *response) || attempt > 0)
+			return response;
+	}
+}
+
+// every structure parsePrivateResponse() fills
+template std::shared_ptr<s_accountInfo> BitmarketPrivate::commandTyped<s_accountInfo>(std::string, std::unordered_map<std::string, std::string>&, bool);
+template std::shared_ptr<s_tradeResult> BitmarketPrivate::commandTyped<s_tradeResult>(std::string, std::unordered_map<std::string, std::string>&, bool);
+template std::shared_ptr<s_cancelResult> BitmarketPrivate::commandTyped<s_cancelResult>(std::string, std::unordered_map<std::string, std::string>&, bool);
+template std::shared_ptr<s_userOrders> BitmarketPrivate::commandTyped<s_userOrders>(std::string, std::unordered_map<std::string, std::string>&, bool);
+template std::shared_ptr<s_userTrades> BitmarketPrivate::commandTyped<s_userTrades>(std::string, std::unordered_map<std::string, std::string>&, bool);
+template std::shared_ptr<s_history> BitmarketPrivate::commandTyped<s_history>(std::string, std::unordered_map<std::string, std::string>&, bool);
+
+std::unordered_map<std::string, std::string> BitmarketPrivate::f_tradeArguments(const std::string& _market, const std::string& _type, const Decimal& _amount, const Decimal& _rate, bool _allOrNothing)
+{
+	std::unordered_map<std::string, std::string> arguments;
+
+	// the API rejects values that are not multiples of market's steps
+	s_marketPrecision _precision = marketPrecision(_market);
+
+	// store every argument in variable
+	// by using unordered_map we can easily store argument name and value
+	arguments["market"]			= _market;
+	arguments["type"]			= _type;
+	arguments["amount"]			= _amount.roundTo(_precision.lot, Decimal::e_down).toString();
+	arguments["rate"]			= _rate.roundTo(_precision.tick).toString();
+	arguments["allOrNothing"]	= _allOrNothing ? "1" : "0";
+
+	return arguments;
+}
+
+bool BitmarketPrivate::f_trackLimit(CommandLimiter& _limiter, const nlohmann::json& _response)
+{
+	// responses look like {"success":true,"data":{...},"limit":{"used":..,"allowed":..,"expires":..}}
+	auto limit = _response.find("limit");
+
+	if (limit != _response.end() && limit->is_object())
+	{
+		auto used = limit->find("used");
+		auto allowed = limit->find("allowed");
+		auto expires = limit->find("expires");
+
+		if (used != limit->end() && used->is_number() && allowed != limit->end() && allowed->is_number() && expires != limit->end() && expires->is_number())
+			_limiter.update(used->get<long>(), allowed->get<long>(), expires->get<long>());
+	}
+
+	// errors look like {"error":506,"errorMsg":"...","time":...}
+	auto error = _response.find("error");
+
+	if (error == _response.end() || !error->is_number() || error->get<int>() != 506)
+		return false;
+
+	_limiter.exceeded();
+	return true;
+}
+
+bool BitmarketPrivate::f_trackLimit(CommandLimiter& _limiter, const s_privateResponse& _response)
+{
+	// the parser leaves -1 when the response has no limit
+	if (_response.limit.used >= 0 && _response.limit.allowed >= 0 && _response.limit.expires >= 0)
+		_limiter.update(_response.limit.used, _response.limit.allowed, _response.limit.expires);
+
+	if (_response.error != 506)
+		return false;
 
-	// create stringstream to transform generated 64-byte hash into HEX-string
-	std::stringstream ss;
-	ss << std::hex;
+	_limiter.exceeded();
+	return true;
+}
 
-	for (int i = 0; i < 64; ++i)
+template <typename Result, typename Call>
+void BitmarketPrivate::f_callback(std::function<void(std::shared_ptr<Result>)> _callback, Call _call)
+{
+	m_executor->post([_callback, _call]() mutable
 	{
-		// add extra '0' char if hexadecimal number is going to be 1-digit long
-		if (hash[i] < 0x10)
-			ss << '0';
+		std::shared_ptr<Result> _result;
+
+		try
+		{
+			_result = _call();
+		}
+		catch (...)
+		{
+			// invalid JSON in the response, reported the same way as a connection error
+			// so that the callback is called for every request
+		}
+
+		_callback(_result);
+	});
+}
+
+std::future<ptr_json> BitmarketPrivate::infoAsync()
+{
+	return m_executor->submit([this]() { return this->info(); });
+}
+
+void BitmarketPrivate::infoAsync(json_callback _callback)
+{
+	f_callback(_callback, [this]() { return this->info(); });
+}
+
+std::future<ptr_json> BitmarketPrivate::tradeAsync(std::string _market, std::string _type, double _amount, double _rate, bool _allOrNothing)
+{
+	return m_executor->submit([this, _market, _type, _amount, _rate, _allOrNothing]() { return this->trade(_market, _type, _amount, _rate, _allOrNothing); });
+}
+
+void BitmarketPrivate::tradeAsync(json_callback _callback, std::string _market, std::string _type, double _amount, double _rate, bool _allOrNothing)
+{
+	f_callback(_callback, [this, _market, _type, _amount, _rate, _allOrNothing]() { return this->trade(_market, _type, _amount, _rate, _allOrNothing); });
+}
+
+std::future<ptr_json> BitmarketPrivate::tradeAsync(std::string _market, std::string _type, Decimal _amount, Decimal _rate, bool _allOrNothing)
+{
+	return m_executor->submit([this, _market, _type, _amount, _rate, _allOrNothing]() { return this->trade(_market, _type, _amount, _rate, _allOrNothing); });
+}
+
+void BitmarketPrivate::tradeAsync(json_callback _callback, std::string _market, std::string _type, Decimal _amount, Decimal _rate, bool _allOrNothing)
+{
+	f_callback(_callback, [this, _market, _type, _amount, _rate, _allOrNothing]() { return this->trade(_market, _type, _amount, _rate, _allOrNothing); });
+}
+
+std::future<ptr_json> BitmarketPrivate::cancelAsync(int _id)
+{
+	return m_executor->submit([this, _id]() { return this->cancel(_id); });
+}
+
+void BitmarketPrivate::cancelAsync(json_callback _callback, int _id)
+{
+	f_callback(_callback, [this, _id]() { return this->cancel(_id); });
+}
+
+std::future<ptr_json> BitmarketPrivate::ordersAsync(std::string _market)
+{
+	return m_executor->submit([this, _market]() { return this->orders(_market); });
+}
+
+void BitmarketPrivate::ordersAsync(json_callback _callback, std::string _market)
+{
+	f_callback(_callback, [this, _market]() { return this->orders(_market); });
+}
+
+std::future<ptr_json> BitmarketPrivate::tradesAsync(std::string _market, int _count, int _start)
+{
+	return m_executor->submit([this, _market, _count, _start]() { return this->trades(_market, _count, _start); });
+}
+
+void BitmarketPrivate::tradesAsync(json_callback _callback, std::string _market, int _count, int _start)
+{
+	f_callback(_callback, [this, _market, _count, _start]() { return this->trades(_market, _count, _start); });
+}
+
+std::future<ptr_json> BitmarketPrivate::historyAsync(std::string _currency, int _count, int _start)
+{
+	return m_executor->submit([this, _currency, _count, _start]() { return this->history(_currency, _count, _start); });
+}
+
+void BitmarketPrivate::historyAsync(json_callback _callback, std::string _currency, int _count, int _start)
+{
+	f_callback(_callback, [this, _currency, _count, _start]() { return this->history(_currency, _count, _start); });
+}
+
+std::future<ptr_json> BitmarketPrivate::commandAsync(std::string _method, std::unordered_map<std::string, std::string> _arguments)
+{
+	// arguments are copied since the request outlives the caller's map
+	return m_executor->submit([this, _method, _arguments]() mutable { return this->command(_method, _arguments); });
+}
+
+void BitmarketPrivate::commandAsync(json_callback _callback, std::string _method, std::unordered_map<std::string, std::string> _arguments)
+{
+	f_callback(_callback, [this, _method, _arguments]() mutable { return this->command(_method, _arguments); });
+}
+
+std::future<std::shared_ptr<s_accountInfo>> BitmarketPrivate::infoTypedAsync()
+{
+	return m_executor->submit([this]() { return this->infoTyped(); });
+}
+
+void BitmarketPrivate::infoTypedAsync(std::function<void(std::shared_ptr<s_accountInfo>)> _callback)
+{
+	f_callback(_callback, [this]() { return this->infoTyped(); });
+}
+
+std::future<std::shared_ptr<s_tradeResult>> BitmarketPrivate::tradeTypedAsync(std::string _market, std::string _type, Decimal _amount, Decimal _rate, bool _allOrNothing)
+{
+	return m_executor->submit([this, _market, _type, _amount, _rate, _allOrNothing]() { return this->tradeTyped(_market, _type, _amount, _rate, _allOrNothing); });
+}
+
+void BitmarketPrivate::tradeTypedAsync(std::function<void(std::shared_ptr<s_tradeResult>)> _callback, std::string _market, std::string _type, Decimal _amount, Decimal _rate, bool _allOrNothing)
+{
+	f_callback(_callback, [this, _market, _type, _amount, _rate, _allOrNothing]() { return this->tradeTyped(_market, _type, _amount, _rate, _allOrNothing); });
+}
+
+std::future<std::shared_ptr<s_cancelResult>> BitmarketPrivate::cancelTypedAsync(int _id)
+{
+	return m_executor->submit([this, _id]() { return this->cancelTyped(_id); });
+}
+
+void BitmarketPrivate::cancelTypedAsync(std::function<void(std::shared_ptr<s_cancelResult>)> _callback, int _id)
+{
+	f_callback(_callback, [this, _id]() { return this->cancelTyped(_id); });
+}
+
+std::future<std::shared_ptr<s_userOrders>> BitmarketPrivate::ordersTypedAsync(std::string _market)
+{
+	return m_executor->submit([this, _market]() { return this->ordersTyped(_market); });
+}
+
+void BitmarketPrivate::ordersTypedAsync(std::function<void(std::shared_ptr<s_userOrders>)> _callback, std::string _market)
+{
+	f_callback(_callback, [this, _market]() { return this->ordersTyped(_market); });
+}
+
+std::future<std::shared_ptr<s_userTrades>> BitmarketPrivate::tradesTypedAsync(std::string _market, int _count, int _start)
+{
+	return m_executor->submit([this, _market, _count, _start]() { return this->tradesTyped(_market, _count, _start); });
+}
+
+void BitmarketPrivate::tradesTypedAsync(std::function<void(std::shared_ptr<s_userTrades>)> _callback, std::string _market, int _count, int _start)
+{
+	f_callback(_callback, [this, _market, _count, _start]() { return this->tradesTyped(_market, _count, _start); });
+}
+
+std::future<std::shared_ptr<s_history>> BitmarketPrivate::historyTypedAsync(std::string _currency, int _count, int _start)
+{
+	return m_executor->submit([this, _currency, _count, _start]() { return this->historyTyped(_currency, _count, _start); });
+}
+
+void BitmarketPrivate::historyTypedAsync(std::function<void(std::shared_ptr<s_history>)> _callback, std::string _currency, int _count, int _start)
+{
+	f_callback(_callback, [this, _currency, _count, _start]() { return this->historyTyped(_currency, _count, _start); });
+}
+
+void BitmarketPrivate::executor(std::shared_ptr<IoExecutor> _executor)
+{
+	m_executor = _executor;
+}
+
+BitmarketPrivate::s_keyedHmac::s_keyedHmac(const std::string& _key)
+	:
+	key(_key),
+	context((const unsigned char*)_key.c_str(), _key.length())
+{ }
 
-		// cast char type to int so that stringstream does not try to use it's ASCII representation
-		ss << static_cast<unsigned short>(hash[i]);
+void BitmarketPrivate::f_sha512(const std::string& _key, const std::string& _data, char (&_hex)[128])
+{
+	static const char hexDigits[] = "0123456789abcdef";
+
+	// both pads of the key are hashed only when the key is used for the first time
+	std::shared_ptr<const s_keyedHmac> keyed = std::atomic_load(&m_keyedHmac);
+
+	if (!keyed || keyed->key != _key)
+	{
+		keyed = std::make_shared<const s_keyedHmac>(_key);
+		std::atomic_store(&m_keyedHmac, keyed);
 	}
 
-	// free occupied memory and return generated HEX-string
-	delete hash;
-	return ss.str();
+	// start from the keyed context on the stack and calculate hash of the data
+	unsigned char hash[CHMAC_SHA512::OUTPUT_SIZE];
+
+	CHMAC_SHA512 hmac(keyed->context);
+	hmac.Write((const unsigned char*)_data.c_str(), _data.length());
+	hmac.Finalize(hash);
+
+	// transform generated 64-byte hash into HEX-string, two digits per byte
+	for (size_t i = 0; i < CHMAC_SHA512::OUTPUT_SIZE; ++i)
+	{
+		_hex[2 * i]		= hexDigits[hash[i] >> 4];
+		_hex[2 * i + 1]	= hexDigits[hash[i] & 0x0f];
+	}
 }
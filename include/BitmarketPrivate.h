@@ -15,9 +15,23 @@
 #include <chrono>			// to_time_t, now
 #include <unordered_map>	// unordered_map
 #include <memory>			// shared_ptr
+#include <future>			// future
+#include <functional>		// function
 
-// Class for handling external python script execution
-#include "PythonNet.h"
+// Class for handling HTTPS connection with Bitmarket API
+#include "HttpsNet.h"
+
+// Thread pool running asynchronous requests
+#include "IoExecutor.h"
+
+// Keeps commands within the limit reported by the API
+#include "CommandLimiter.h"
+
+// Fixed-point prices and amounts
+#include "Decimal.h"
+
+// One-pass parsers filling typed results of commands
+#include "PrivateApiParsers.h"
 
 // Modified methods to generate HMAC SHA512 hash
 #include "crypto/hmac_sha512.h"
@@ -26,6 +40,7 @@
 #include "nlohmann/json.hpp"
 
 typedef std::shared_ptr<nlohmann::json> ptr_json;
+typedef std::function<void(ptr_json)> json_callback;
 
 class BitmarketPrivate
 {
@@ -33,6 +48,13 @@ public:
 	BitmarketPrivate();
 	BitmarketPrivate(std::string _public, std::string _private);
 
+	/**
+		Constructor that uses given connection pool instead of the shared one
+
+		@param _pool pool of keep-alive connections to the API host
+	*/
+	BitmarketPrivate(std::string _public, std::string _private, std::shared_ptr<HttpsConnectionPool> _pool);
+
 	/**
 		Obtains account information
 
@@ -87,6 +109,12 @@ public:
 	*/
 	ptr_json trade(std::string _market, std::string _type, double _amount, double _rate, bool _allOrNothing);
 
+	/**
+		Submits an order, see the method above. The amount is rounded down to market's lot
+		and the rate to the nearest tick (see marketPrecision()), both are sent exactly
+	*/
+	ptr_json trade(std::string _market, std::string _type, Decimal _amount, Decimal _rate, bool _allOrNothing);
+
 	/**
 		Calcels na order request
 
@@ -162,12 +190,30 @@ public:
 					"cancel" - order cancellation.
 	*/
 	ptr_json history(std::string _currency, int _count, int _start);
+
+	/*
+		Typed variants of the methods above. The response is parsed in one
+		pass straight into a structure from PrivateApiDataStructures.h, no
+		JSON document is built unless the result's json view is asked for.
+		They return nullptr on connection error or invalid response, errors
+		reported by the API are in the result's error and errorMsg.
+	*/
+
+	std::shared_ptr<s_accountInfo>	infoTyped();
+	std::shared_ptr<s_tradeResult>	tradeTyped(std::string _market, std::string _type, Decimal _amount, Decimal _rate, bool _allOrNothing);
+	std::shared_ptr<s_cancelResult>	cancelTyped(int _id);
+	std::shared_ptr<s_userOrders>	ordersTyped(std::string _market);
+	std::shared_ptr<s_userTrades>	tradesTyped(std::string _market, int _count, int _start);
+	std::shared_ptr<s_history>		historyTyped(std::string _currency, int _count, int _start);
 	
 	// TODO: other API methods
 
 	/**
 		Changes python file localization
 
+		Deprecated: requests are sent by in-process HttpsNet transport so
+		python script is no longer used. Kept for source compatibility.
+
 		@param _scriptName - name of python script file
 		@param _path - directory where the script file is located
 	*/
@@ -186,24 +232,161 @@ public:
 	/**
 		Sends custom request to Bitmarket API
 
+		The request waits until the limit of commands allows to send it. When
+		the API rejects it anyway with error 506, it's sent once more after
+		the limit's window expires.
+
 		@param _method - method name
 		@param _arguments - arguments included in this request
+		@param _reserved - the caller has already reserved the command in limiter()
 
 		@return  Nlohmann's JSON data structure representing API's response
 	*/
-	ptr_json command(std::string _method, std::unordered_map<std::string, std::string>& _arguments);
+	ptr_json command(std::string _method, std::unordered_map<std::string, std::string>& _arguments, bool _reserved = false);
+
+	/**
+		Sends custom request like command() and parses the response into a structure
+
+		@param Result - one of the result structures from PrivateApiDataStructures.h, matching _method
+
+		@return parsed response or nullptr on connection error or invalid response
+	*/
+	template <typename Result>
+	std::shared_ptr<Result> commandTyped(std::string _method, std::unordered_map<std::string, std::string>& _arguments, bool _reserved = false);
+
+	/**
+		Returns number of commands that may still be sent in the current window
+
+		@return -1 until the first response tells the limit
+	*/
+	long remaining();
+
+	/**
+		Returns limiter shared by every object using the same public key
+	*/
+	std::shared_ptr<CommandLimiter> limiter();
+
+	/*
+		Asynchronous variants of the methods above. They return immediately and
+		run the request on the executor's thread. Either a future is returned or
+		given callback is called from the executor's thread with the response
+		(nullptr on error). The object must outlive every pending request.
+	*/
+
+	std::future<ptr_json>	infoAsync();
+	void					infoAsync(json_callback _callback);
+
+	std::future<ptr_json>	tradeAsync(std::string _market, std::string _type, double _amount, double _rate, bool _allOrNothing);
+	void					tradeAsync(json_callback _callback, std::string _market, std::string _type, double _amount, double _rate, bool _allOrNothing);
+
+	std::future<ptr_json>	tradeAsync(std::string _market, std::string _type, Decimal _amount, Decimal _rate, bool _allOrNothing);
+	void					tradeAsync(json_callback _callback, std::string _market, std::string _type, Decimal _amount, Decimal _rate, bool _allOrNothing);
+
+	std::future<ptr_json>	cancelAsync(int _id);
+	void					cancelAsync(json_callback _callback, int _id);
+
+	std::future<ptr_json>	ordersAsync(std::string _market);
+	void					ordersAsync(json_callback _callback, std::string _market);
+
+	std::future<ptr_json>	tradesAsync(std::string _market, int _count, int _start);
+	void					tradesAsync(json_callback _callback, std::string _market, int _count, int _start);
+
+	std::future<ptr_json>	historyAsync(std::string _currency, int _count, int _start);
+	void					historyAsync(json_callback _callback, std::string _currency, int _count, int _start);
+
+	std::future<ptr_json>	commandAsync(std::string _method, std::unordered_map<std::string, std::string> _arguments);
+	void					commandAsync(json_callback _callback, std::string _method, std::unordered_map<std::string, std::string> _arguments);
+
+	std::future<std::shared_ptr<s_accountInfo>>	infoTypedAsync();
+	void										infoTypedAsync(std::function<void(std::shared_ptr<s_accountInfo>)> _callback);
+
+	std::future<std::shared_ptr<s_tradeResult>>	tradeTypedAsync(std::string _market, std::string _type, Decimal _amount, Decimal _rate, bool _allOrNothing);
+	void										tradeTypedAsync(std::function<void(std::shared_ptr<s_tradeResult>)> _callback, std::string _market, std::string _type, Decimal _amount, Decimal _rate, bool _allOrNothing);
+
+	std::future<std::shared_ptr<s_cancelResult>>	cancelTypedAsync(int _id);
+	void											cancelTypedAsync(std::function<void(std::shared_ptr<s_cancelResult>)> _callback, int _id);
+
+	std::future<std::shared_ptr<s_userOrders>>	ordersTypedAsync(std::string _market);
+	void										ordersTypedAsync(std::function<void(std::shared_ptr<s_userOrders>)> _callback, std::string _market);
+
+	std::future<std::shared_ptr<s_userTrades>>	tradesTypedAsync(std::string _market, int _count, int _start);
+	void										tradesTypedAsync(std::function<void(std::shared_ptr<s_userTrades>)> _callback, std::string _market, int _count, int _start);
+
+	std::future<std::shared_ptr<s_history>>		historyTypedAsync(std::string _currency, int _count, int _start);
+	void										historyTypedAsync(std::function<void(std::shared_ptr<s_history>)> _callback, std::string _currency, int _count, int _start);
+
+	/**
+		Changes executor asynchronous requests are run on
+
+		@param _executor thread pool, IoExecutor::shared() is used by default
+	*/
+	void executor(std::shared_ptr<IoExecutor> _executor);
 
 private:
+	/**
+		Signs and sends a command, returns the body as it came
+
+		@return nullptr on connection error or empty response
+	*/
+	std::shared_ptr<ResponseBuffer> f_post(const std::string& _method, const std::unordered_map<std::string, std::string>& _arguments);
+
+	/**
+		Sends a command when the limit allows, the way command() describes, and parses the response
+
+		@param _reserved the first attempt has already been reserved in the limiter
+		@param _parse turns the body into Result, nullptr if it's invalid
+		@return parsed response or nullptr on connection error
+	*/
+	template <typename Result, typename Parse>
+	std::shared_ptr<Result> f_limited(const std::string& _method, const std::unordered_map<std::string, std::string>& _arguments, bool _reserved, Parse _parse);
+
+	/**
+		Returns arguments of "trade" command, amount rounded down to market's lot and rate to the nearest tick
+	*/
+	std::unordered_map<std::string, std::string> f_tradeArguments(const std::string& _market, const std::string& _type, const Decimal& _amount, const Decimal& _rate, bool _allOrNothing);
+
+	/**
+		Runs _call on the executor and passes its result to _callback, an exception
+		thrown by _call is reported as nullptr
+	*/
+	template <typename Result, typename Call>
+	void f_callback(std::function<void(std::shared_ptr<Result>)> _callback, Call _call);
+
+	/**
+		Passes "limit" object of the response to the limiter
+
+		@return true if the command has been rejected with error 506
+	*/
+	bool f_trackLimit(CommandLimiter& _limiter, const nlohmann::json& _response);
+	bool f_trackLimit(CommandLimiter& _limiter, const s_privateResponse& _response);
+
 	/**
 		This function generates HMAC SHA512 of given data using given key.
+		Hashing of the key is done once and reused until the key changes,
+		nothing is allocated on the heap.
 
 		@param _key is a private key from bitmarket API
 		@param _data is a data we want to send
-		@return HMAC SHA512 of given input	
+		@param _hex receives HMAC SHA512 of given input as 128 lowercase hex digits
+	*/
+	void f_sha512(const std::string& _key, const std::string& _data, char (&_hex)[128]);
+
+	/**
+		HMAC context with the key already absorbed, every request starts from it
 	*/
-	std::string f_sha512(std::string _key, std::string _data);
+	struct s_keyedHmac
+	{
+		s_keyedHmac(const std::string& _key);
+
+		std::string key;
+		CHMAC_SHA512::Context context;
+	};
+
+	// replaced atomically when the private key changes, requests may run on many threads
+	std::shared_ptr<const s_keyedHmac> m_keyedHmac;
 
-	PythonNet m_pythonNet;
+	HttpsNet m_httpsNet;
+	std::shared_ptr<IoExecutor> m_executor;
 
 	// std::unordered_map<int, std::string> m_errorCodes;
 };
@@ -9,26 +9,77 @@
 
 #include "BitmarketPublic.h"
 
-BitmarketPublic::BitmarketPublic()
-{ 
-	m_pythonNet.m_pyFile = "bitmarket_python.py";
-	m_pythonNet.m_pyPath = "pythonScript";
+BitmarketPublic::BitmarketPublic() : m_executor(IoExecutor::shared())
+{ }
+
+BitmarketPublic::BitmarketPublic(std::shared_ptr<HttpsConnectionPool> _pool) : m_httpsNet(_pool), m_executor(IoExecutor::shared())
+{ }
+
+std::shared_ptr<const s_ticker> BitmarketPublic::ticker(std::string _market)
+{
+	HttpsNet _net = m_httpsNet;
+	std::string _url = "/json/" + _market + "/ticker.json";
+
+	// with a cache set the request is sent only when there's no fresh ticker, see cache();
+	// the request may be sent in the background after this object is gone, so it
+	// keeps its own copy of the transport instead of referring to this
+	return f_cached<s_ticker>(_url, [_net, _url](HttpsNet::s_validators& _validators) mutable { return f_ticker(_net, _url, _validators); });
 }
 
-std::shared_ptr<s_ticker> BitmarketPublic::ticker(std::string _market)
+std::shared_ptr<const s_orderBook> BitmarketPublic::orderbook(std::string _market)
 {
-	// obtain appropriate data from Bitmarket API
-	std::string _data = m_pythonNet.get("/json/" + _market + "/ticker.json");
+	HttpsNet _net = m_httpsNet;
+	std::string _url = "/json/" + _market + "/orderbook.json";
+
+	return f_cached<s_orderBook>(_url, [_net, _url](HttpsNet::s_validators& _validators) mutable { return f_orderbook(_net, _url, _validators); });
+}
+
+std::shared_ptr<const s_fixedOrderBook> BitmarketPublic::orderbookFixed(std::string _market)
+{
+	HttpsNet _net = m_httpsNet;
+	std::string _url = "/json/" + _market + "/orderbook.json";
+
+	return f_cached<s_fixedOrderBook>(_url, [_net, _url](HttpsNet::s_validators& _validators) mutable { return f_orderbookFixed(_net, _url, _validators); });
+}
+
+std::shared_ptr<const s_trades> BitmarketPublic::trades(int _since, std::string _market)
+{
+	HttpsNet _net = m_httpsNet;
+	std::string _url = "/json/" + _market + "/trades.json" + (_since < 0 ? "" : "?since=" + std::to_string(_since));
+
+	return f_cached<s_trades>(_url, [_net, _url](HttpsNet::s_validators& _validators) mutable { return f_trades(_net, _url, _validators); });
+}
 
-	// check if PythonNet::get didn't encounter any error
-	if(_data.empty())
+std::shared_ptr<const s_fixedTrades> BitmarketPublic::tradesFixed(int _since, std::string _market)
+{
+	HttpsNet _net = m_httpsNet;
+	std::string _url = "/json/" + _market + "/trades.json" + (_since < 0 ? "" : "?since=" + std::to_string(_since));
+
+	return f_cached<s_fixedTrades>(_url, [_net, _url](HttpsNet::s_validators& _validators) mutable { return f_tradesFixed(_net, _url, _validators); });
+}
+
+std::shared_ptr<const s_graph> BitmarketPublic::graphs(std::string _interval, std::string _market)
+{
+	HttpsNet _net = m_httpsNet;
+	std::string _url = "/graphs/" + _market + "/" + _interval + ".json";
+
+	return f_cached<s_graph>(_url, [_net, _url, _interval, _market](HttpsNet::s_validators& _validators) mutable { return f_graphs(_net, _url, _validators, _interval, _market); });
+}
+
+std::shared_ptr<s_ticker> BitmarketPublic::f_ticker(HttpsNet& _net, const std::string& _url, HttpsNet::s_validators& _validators)
+{
+	// obtain appropriate data from Bitmarket API, the body stays in transport's buffer
+	std::shared_ptr<ResponseBuffer> _data = _net.getBuffer(_url, _validators);
+
+	// check if HttpsNet::getBuffer didn't encounter any error
+	if (!_data || _data->empty())
 		return nullptr;
 
 	// TODO: implement better exceptions handling for this project
 	try 
 	{
 		// parse obtained data into nlohmann json structure
-		auto _jsonDocument = nlohmann::json::parse(_data);
+		auto _jsonDocument = nlohmann::json::parse(_data->data(), _data->data() + _data->size());
 
 		// declare pointer to a desired data structure
 		std::shared_ptr<s_ticker> _retValue(new s_ticker);
@@ -51,148 +102,114 @@ std::shared_ptr<s_ticker> BitmarketPublic::ticker(std::string _market)
 	}
 }
 
-std::shared_ptr<s_orderBook> BitmarketPublic::orderbook(std::string _market)
+std::shared_ptr<s_orderBook> BitmarketPublic::f_orderbook(HttpsNet& _net, const std::string& _url, HttpsNet::s_validators& _validators)
 {
 	// obtain appropriate data from Bitmarket API
-	std::string _data = m_pythonNet.get("/json/" + _market + "/orderbook.json");
+	std::shared_ptr<ResponseBuffer> _data = _net.getBuffer(_url, _validators);
 
-	// check if PythonNet::get didn't encounter any error
-	if (_data.empty())
+	// check if HttpsNet::getBuffer didn't encounter any error
+	if (!_data || _data->empty())
 		return nullptr;
 
-	// TODO: implement better exceptions handling for this project
-	try
-	{
-		// parse obtained data into nlohmann json structure
-		auto _jsonDocument = nlohmann::json::parse(_data);
+	// declare pointer to a desired data structure
+	std::shared_ptr<s_orderBook> _retValue(new s_orderBook);
 
-		// declare pointer to a desired data structure
-		std::shared_ptr<s_orderBook> _retValue(new s_orderBook);
-
-		// iterate through every element in 'asks' table
-		for (auto _element : _jsonDocument["asks"])
-		{
-			_retValue->asks.push_back({ 
-				_element[0].get<double>(), 
-				_element[1].get<double>() 
-			});
-		}
-
-		// iterate through every element in 'bids' table
-		for (auto _element : _jsonDocument["bids"])
-		{
-			_retValue->bids.push_back({ 
-				_element[0].get<double>(), 
-				_element[1].get<double>() 
-			});
-		}
+	// parse obtained data directly into the structure, without json document in between
+	if (!parseOrderBook(_data->data(), _data->size(), *_retValue))
+		return nullptr;
 
-		// return smart pointer
-		return _retValue;
-	}
-	catch (...)
-	{
+	// return smart pointer
+	return _retValue;
+}
+
+std::shared_ptr<s_fixedOrderBook> BitmarketPublic::f_orderbookFixed(HttpsNet& _net, const std::string& _url, HttpsNet::s_validators& _validators)
+{
+	std::shared_ptr<ResponseBuffer> _data = _net.getBuffer(_url, _validators);
+
+	if (!_data || _data->empty())
 		return nullptr;
-	}
+
+	std::shared_ptr<s_fixedOrderBook> _retValue(new s_fixedOrderBook);
+
+	if (!parseOrderBook(_data->data(), _data->size(), *_retValue))
+		return nullptr;
+
+	return _retValue;
 }
 
-std::shared_ptr<s_trades> BitmarketPublic::trades(int _since, std::string _market)
+std::shared_ptr<s_trades> BitmarketPublic::f_trades(HttpsNet& _net, const std::string& _url, HttpsNet::s_validators& _validators)
 {
 	// obtain appropriate data from Bitmarket API
-	std::string _data = m_pythonNet.get("/json/" + _market + "/trades.json" + (_since < 0 ? "" : "?since=" + std::to_string(_since)));
+	std::shared_ptr<ResponseBuffer> _data = _net.getBuffer(_url, _validators);
 
-	// check if PythonNet::get didn't encounter any error
-	if (_data.empty())
+	// check if HttpsNet::getBuffer didn't encounter any error
+	if (!_data || _data->empty())
 		return nullptr;
 
-	// TODO: implement better exceptions handling for this project
-	try
-	{
-		// parse obtained data into nlohmann json structure
-		auto _jsonDocument = nlohmann::json::parse(_data);
+	// declare pointer to a desired data structure
+	std::shared_ptr<s_trades> _retValue(new s_trades);
 
-		// declare pointer to a desired data structure
-		std::shared_ptr<s_trades> _retValue(new s_trades);
+	// parse obtained data directly into the structure, without json document in between
+	if (!parseTrades(_data->data(), _data->size(), *_retValue))
+		return nullptr;
 
-		// iterate through every element
-		for (auto _element : _jsonDocument)
-		{
-			_retValue->trades.push_back({
-				_element["amount"].get<double>(),
-				_element["price"].get<double>(),
-				_element["date"].get<long>(),
-				_element["tid"].get<long>(),
-				_element["type"].get<std::string>()
-			});
-		}
+	// return smart pointer
+	return _retValue;
+}
 
-		// return smart pointer
-		return _retValue;
-	}
-	catch (...)
-	{
+std::shared_ptr<s_fixedTrades> BitmarketPublic::f_tradesFixed(HttpsNet& _net, const std::string& _url, HttpsNet::s_validators& _validators)
+{
+	std::shared_ptr<ResponseBuffer> _data = _net.getBuffer(_url, _validators);
+
+	if (!_data || _data->empty())
 		return nullptr;
-	}
+
+	std::shared_ptr<s_fixedTrades> _retValue(new s_fixedTrades);
+
+	if (!parseTrades(_data->data(), _data->size(), *_retValue))
+		return nullptr;
+
+	return _retValue;
 }
 
-std::shared_ptr<s_graph> BitmarketPublic::graphs(std::string _interval, std::string _market)
+std::shared_ptr<s_graph> BitmarketPublic::f_graphs(HttpsNet& _net, const std::string& _url, HttpsNet::s_validators& _validators, const std::string& _interval, const std::string& _market)
 {
 	// obtain appropriate data from Bitmarket API
-	std::string _data = m_pythonNet.get("/graphs/" + _market + "/" + _interval + ".json");
+	std::shared_ptr<ResponseBuffer> _data = _net.getBuffer(_url, _validators);
 
-	// check if PythonNet::get didn't encounter any error
-	if (_data.empty())
+	// check if HttpsNet::getBuffer didn't encounter any error
+	if (!_data || _data->empty())
 		return nullptr;
 
-	// TODO: implement better exceptions handling for this project
-	try
-	{
-		// parse obtained data into nlohmann json structure
-		auto _jsonDocument = nlohmann::json::parse(_data);
+	// declare pointer to a desired data structure
+	std::shared_ptr<s_graph> _retValue(new s_graph);
 
-		// declare pointer to a desired data structure
-		std::shared_ptr<s_graph> _retValue(new s_graph);
-
-		// set market and interval information
-		_retValue->m_interval = _interval;
-		_retValue->m_market = _market;
-
-		// iterate through every element
-		for (auto _element : _jsonDocument)
-		{
-			_retValue->points.push_back({
-				_element["time"].get<long>(),
-				std::stod(_element["open"].get<std::string>()),
-				std::stod(_element["high"].get<std::string>()),
-				std::stod(_element["low"].get<std::string>()),
-				std::stod(_element["close"].get<std::string>()),
-				std::stod(_element["vol"].get<std::string>())
-			});
-		}
+	// set market and interval information
+	_retValue->m_interval = _interval;
+	_retValue->m_market = _market;
 
-		// return smart pointer
-		return _retValue;
-	}
-	catch (...)
-	{
+	// parse obtained data directly into the structure, prices written as strings are converted in place
+	if (!parseGraph(_data->data(), _data->size(), *_retValue))
 		return nullptr;
-	}
+
+	// return smart pointer
+	return _retValue;
 }
 
 std::shared_ptr<s_transfer> BitmarketPublic::ctransfer(std::string _tx, std::string _from, std::string _to)
 {	
 	// obtain appropriate data from Bitmarket API
-	std::string _data = m_pythonNet.get("/json/ctransfer.json?tx=" + _tx + "&from=" + _from + "&to=" + _to);
+	std::shared_ptr<ResponseBuffer> _data = m_httpsNet.getBuffer("/json/ctransfer.json?tx=" + _tx + "&from=" + _from + "&to=" + _to);
 
-	// check if PythonNet::get didn't encounter any error
-	if (_data.empty())
+	// check if HttpsNet::getBuffer didn't encounter any error
+	if (!_data || _data->empty())
 		return nullptr;
 
 	// TODO: implement better exceptions handling for this project
 	try
 	{
 		// parse obtained data into nlohmann json structure
-		auto _jsonDocument = nlohmann::json::parse(_data);
+		auto _jsonDocument = nlohmann::json::parse(_data->data(), _data->data() + _data->size());
 
 		// declare pointer to a desired data structure
 		std::shared_ptr<s_transfer> _retValue(new s_transfer);
@@ -210,5 +227,74 @@ std::shared_ptr<s_transfer> BitmarketPublic::ctransfer(std::string _tx, std::str
 	}
 }
 
+std::future<std::shared_ptr<const s_ticker>> BitmarketPublic::tickerAsync(std::string _market)
+{
+	return m_executor->submit([this, _market]() { return this->ticker(_market); });
+}
+
+void BitmarketPublic::tickerAsync(std::function<void(std::shared_ptr<const s_ticker>)> _callback, std::string _market)
+{
+	m_executor->post([this, _callback, _market]() { _callback(this->ticker(_market)); });
+}
+
+std::future<std::shared_ptr<const s_orderBook>> BitmarketPublic::orderbookAsync(std::string _market)
+{
+	return m_executor->submit([this, _market]() { return this->orderbook(_market); });
+}
+
+void BitmarketPublic::orderbookAsync(std::function<void(std::shared_ptr<const s_orderBook>)> _callback, std::string _market)
+{
+	m_executor->post([this, _callback, _market]() { _callback(this->orderbook(_market)); });
+}
+
+std::future<std::shared_ptr<const s_fixedOrderBook>> BitmarketPublic::orderbookFixedAsync(std::string _market)
+{
+	return m_executor->submit([this, _market]() { return this->orderbookFixed(_market); });
+}
+
+void BitmarketPublic::orderbookFixedAsync(std::function<void(std::shared_ptr<const s_fixedOrderBook>)> _callback, std::string _market)
+{
+	m_executor->post([this, _callback, _market]() { _callback(this->orderbookFixed(_market)); });
+}
+
+std::future<std::shared_ptr<const s_trades>> BitmarketPublic::tradesAsync(int _since, std::string _market)
+{
+	return m_executor->submit([this, _since, _market]() { return this->trades(_since, _market); });
+}
+
+void BitmarketPublic::tradesAsync(std::function<void(std::shared_ptr<const s_trades>)> _callback, int _since, std::string _market)
+{
+	m_executor->post([this, _callback, _since, _market]() { _callback(this->trades(_since, _market)); });
+}
+
+std::future<std::shared_ptr<const s_fixedTrades>> BitmarketPublic::tradesFixedAsync(int _since, std::string _market)
+{
+	return m_executor->submit([this, _since, _market]() { return this->tradesFixed(_since, _market); });
+}
+
+void BitmarketPublic::tradesFixedAsync(std::function<void(std::shared_ptr<const s_fixedTrades>)> _callback, int _since, std::string _market)
+{
+	m_executor->post([this, _callback, _since, _market]() { _callback(this->tradesFixed(_since, _market)); });
+}
+
+std::future<std::shared_ptr<const s_graph>> BitmarketPublic::graphsAsync(std::string _interval, std::string _market)
+{
+	return m_executor->submit([this, _interval, _market]() { return this->graphs(_interval, _market); });
+}
+
+void BitmarketPublic::graphsAsync(std::function<void(std::shared_ptr<const s_graph>)> _callback, std::string _interval, std::string _market)
+{
+	m_executor->post([this, _callback, _interval, _market]() { _callback(this->graphs(_interval, _market)); });
+}
+
+void BitmarketPublic::executor(std::shared_ptr<IoExecutor> _executor)
+{
+	m_executor = _executor;
+}
+
+void BitmarketPublic::cache(std::shared_ptr<ResponseCache> _cache)
+{
+	m_cache = _cache;
+}
 
 
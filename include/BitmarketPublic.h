@@ -7,18 +7,35 @@
 	part of Bitmarket API's description. If you need more detailed
 	information visit <https://www.bitmarket.pl/docs.php?file=api_public.html>.
 	Or <https://www.bitmarket.net/docs.php?file=api_public.html> for English.
+
+	Threads asking for the same data at once share one request and its
+	parsed result (see SingleFlight), so results are pointers to const.
 */
 
 #ifndef BITMARKETPUBLIC_H
 #define BITMARKETPUBLIC_H
 
-#include <memory>	// shared_ptr
+#include <memory>		// shared_ptr
+#include <future>		// future
+#include <functional>	// function
 
 // Defines structures that are used to store public API's data
 #include "PublicApiDataStructures.h"
 
-// Class for handling external python script execution
-#include "PythonNet.h"
+// One-pass parsers filling the structures above
+#include "PublicApiParsers.h"
+
+// Class for handling HTTPS connection with Bitmarket API
+#include "HttpsNet.h"
+
+// Thread pool running asynchronous requests
+#include "IoExecutor.h"
+
+// Cache of parsed responses shared by many objects
+#include "ResponseCache.h"
+
+// Shares identical requests in flight
+#include "SingleFlight.h"
 
 // Nlohmann's json library https://github.com/nlohmann/json
 #include "nlohmann/json.hpp"
@@ -27,23 +44,37 @@ class BitmarketPublic
 {
 public:
 	/**
-		Default and only constructor
+		Default constructor, uses connection pool shared by every Bitmarket API object
 	*/
 	BitmarketPublic();
 
+	/**
+		Constructor that uses given connection pool
+
+		@param _pool pool of keep-alive connections to the API host
+	*/
+	BitmarketPublic(std::shared_ptr<HttpsConnectionPool> _pool);
+
 	/**
 		Parses API's ticker.json file content into s_ticker struct
 
 		@return smart pointer to an appropriate data structure
 	*/
-	std::shared_ptr<s_ticker>		ticker(std::string _market = "BTCPLN");
+	std::shared_ptr<const s_ticker>			ticker(std::string _market = "BTCPLN");
 
 	/**
 		Parses API's orderbook.json file content into s_orderBook struct
 
 		@return smart pointer to an appropriate data structure
 	*/
-	std::shared_ptr<s_orderBook>	orderbook(std::string _market = "BTCPLN");
+	std::shared_ptr<const s_orderBook>		orderbook(std::string _market = "BTCPLN");
+
+	/**
+		Parses API's orderbook.json file content into s_fixedOrderBook struct, rates and amounts are exact
+
+		@return smart pointer to an appropriate data structure
+	*/
+	std::shared_ptr<const s_fixedOrderBook>	orderbookFixed(std::string _market = "BTCPLN");
 
 	/**
 		Parses API's trades.json file content into s_trades struct
@@ -51,7 +82,15 @@ public:
 		@param _since when set then request will download 500 trades that follow this transaction id; if not then request downloads trades from last hour - container size may vary!
 		@return smart pointer to an appropriate data structure
 	*/
-	std::shared_ptr<s_trades>		trades(int _since = -1, std::string _market = "BTCPLN");
+	std::shared_ptr<const s_trades>			trades(int _since = -1, std::string _market = "BTCPLN");
+
+	/**
+		Parses API's trades.json file content into s_fixedTrades struct, prices and amounts are exact
+
+		@param _since see trades()
+		@return smart pointer to an appropriate data structure
+	*/
+	std::shared_ptr<const s_fixedTrades>	tradesFixed(int _since = -1, std::string _market = "BTCPLN");
 
 	/**
 		Parses json file that contains 90 data points from given interval and market into s_graph struct
@@ -60,7 +99,7 @@ public:
 		@param _interval string choosen out of { 90m, 6h, 1d, 7d, 1m, 3m, 6m, 1y }
 		@return smart pointer to an appropriate data structure
 	*/
-	std::shared_ptr<s_graph>		graphs(std::string interval, std::string _market = "BTCPLN");
+	std::shared_ptr<const s_graph>			graphs(std::string interval, std::string _market = "BTCPLN");
 
 	/**
 		Parses API's ctransfer.json file content into s_transfer struct
@@ -70,10 +109,86 @@ public:
 		@param _to login name of the receiver
 		@return smart pointer to an appropriate data structure
 	*/
-	std::shared_ptr<s_transfer>		ctransfer(std::string _tx, std::string _from, std::string _to);
+	std::shared_ptr<s_transfer>				ctransfer(std::string _tx, std::string _from, std::string _to);
+
+	/*
+		Asynchronous variants of the methods above. They return immediately and
+		run the request on the executor's thread. Either a future is returned or
+		given callback is called from the executor's thread with the result
+		(nullptr on error). The object must outlive every pending request.
+	*/
+
+	std::future<std::shared_ptr<const s_ticker>>			tickerAsync(std::string _market = "BTCPLN");
+	void													tickerAsync(std::function<void(std::shared_ptr<const s_ticker>)> _callback, std::string _market = "BTCPLN");
+
+	std::future<std::shared_ptr<const s_orderBook>>			orderbookAsync(std::string _market = "BTCPLN");
+	void													orderbookAsync(std::function<void(std::shared_ptr<const s_orderBook>)> _callback, std::string _market = "BTCPLN");
+
+	std::future<std::shared_ptr<const s_fixedOrderBook>>	orderbookFixedAsync(std::string _market = "BTCPLN");
+	void													orderbookFixedAsync(std::function<void(std::shared_ptr<const s_fixedOrderBook>)> _callback, std::string _market = "BTCPLN");
+
+	std::future<std::shared_ptr<const s_trades>>			tradesAsync(int _since = -1, std::string _market = "BTCPLN");
+	void													tradesAsync(std::function<void(std::shared_ptr<const s_trades>)> _callback, int _since = -1, std::string _market = "BTCPLN");
+
+	std::future<std::shared_ptr<const s_fixedTrades>>		tradesFixedAsync(int _since = -1, std::string _market = "BTCPLN");
+	void													tradesFixedAsync(std::function<void(std::shared_ptr<const s_fixedTrades>)> _callback, int _since = -1, std::string _market = "BTCPLN");
+
+	std::future<std::shared_ptr<const s_graph>>				graphsAsync(std::string _interval, std::string _market = "BTCPLN");
+	void													graphsAsync(std::function<void(std::shared_ptr<const s_graph>)> _callback, std::string _interval, std::string _market = "BTCPLN");
+
+	/**
+		Changes executor asynchronous requests are run on
+
+		@param _executor thread pool, IoExecutor::shared() is used by default
+	*/
+	void executor(std::shared_ptr<IoExecutor> _executor);
+
+	/**
+		Sets cache of responses used by ticker(), orderbook(), trades(), graphs() and their variants
+
+		@param _cache cache that may be shared by many objects, nullptr (the default) sends every request
+	*/
+	void cache(std::shared_ptr<ResponseCache> _cache);
 
 private:
-	PythonNet m_pythonNet;
+	/**
+		Returns result of _fetch through the cache, if there's one. Without it identical
+		requests in flight, from any object in the process, still share one result.
+		Objects may use pools connected to different hosts, so the host is a part of the key.
+		Only the cache has validators of a previous response, without it they are empty
+	*/
+	template <typename T>
+	std::shared_ptr<const T> f_cached(const std::string& _url, std::function<std::shared_ptr<T>(HttpsNet::s_validators&)> _fetch)
+	{
+		std::shared_ptr<ResponseCache> _cache = m_cache;
+		std::string _key = m_httpsNet.pool()->host() + _url;
+
+		if (_cache)
+			return _cache->get<T>(_key, std::move(_fetch));
+
+		return SingleFlight<std::string, T>::shared()->run(_key, [&_fetch]()
+		{
+			HttpsNet::s_validators _validators = { std::string(), std::string(), false };
+			return _fetch(_validators);
+		});
+	}
+
+	/*
+		Requests sent by the methods above, through the given transport only since
+		a cache may run them after the object that asked has been destroyed; they
+		return nullptr when the server answers that the cached result hasn't changed
+	*/
+
+	static std::shared_ptr<s_ticker>			f_ticker(HttpsNet& _net, const std::string& _url, HttpsNet::s_validators& _validators);
+	static std::shared_ptr<s_orderBook>			f_orderbook(HttpsNet& _net, const std::string& _url, HttpsNet::s_validators& _validators);
+	static std::shared_ptr<s_fixedOrderBook>	f_orderbookFixed(HttpsNet& _net, const std::string& _url, HttpsNet::s_validators& _validators);
+	static std::shared_ptr<s_trades>			f_trades(HttpsNet& _net, const std::string& _url, HttpsNet::s_validators& _validators);
+	static std::shared_ptr<s_fixedTrades>		f_tradesFixed(HttpsNet& _net, const std::string& _url, HttpsNet::s_validators& _validators);
+	static std::shared_ptr<s_graph>				f_graphs(HttpsNet& _net, const std::string& _url, HttpsNet::s_validators& _validators, const std::string& _interval, const std::string& _market);
+
+	HttpsNet m_httpsNet;
+	std::shared_ptr<IoExecutor> m_executor;
+	std::shared_ptr<ResponseCache> m_cache;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,82 @@
+/*
+	Copyright (c) 2019 Maciej Goncerz <https://github.com/Paurin1>.
+	Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+	More detailed descriptions are in CandleColumns.h file.
+*/
+
+#include "CandleColumns.h"
+
+// Defines s_graphPoint
+#include "PublicApiDataStructures.h"
+
+template <typename Long, typename Double>
+CandleColumns::s_basicPointRef<Long, Double>::operator s_graphPoint() const
+{
+	return { time, open, high, low, close, vol };
+}
+
+template <typename Long, typename Double>
+CandleColumns::s_basicPointRef<Long, Double>& CandleColumns::s_basicPointRef<Long, Double>::operator=(const s_graphPoint& _point)
+{
+	time = _point.time;
+	open = _point.open;
+	high = _point.high;
+	low = _point.low;
+	close = _point.close;
+	vol = _point.vol;
+	return *this;
+}
+
+// the only two views there are, only the mutable one can be written
+template CandleColumns::s_basicPointRef<long, double>::operator s_graphPoint() const;
+template CandleColumns::s_basicPointRef<const long, const double>::operator s_graphPoint() const;
+template CandleColumns::s_pointRef& CandleColumns::s_basicPointRef<long, double>::operator=(const s_graphPoint&);
+
+void swap(CandleColumns::s_pointRef _a, CandleColumns::s_pointRef _b)
+{
+	s_graphPoint _copy = _a;
+	_a = _b;
+	_b = _copy;
+}
+
+void CandleColumns::reserve(size_t _count)
+{
+	m_time.reserve(_count);
+	m_open.reserve(_count);
+	m_high.reserve(_count);
+	m_low.reserve(_count);
+	m_close.reserve(_count);
+	m_vol.reserve(_count);
+}
+
+void CandleColumns::clear()
+{
+	m_time.clear();
+	m_open.clear();
+	m_high.clear();
+	m_low.clear();
+	m_close.clear();
+	m_vol.clear();
+}
+
+void CandleColumns::push_back(const s_graphPoint& _point)
+{
+	m_time.push_back(_point.time);
+	m_open.push_back(_point.open);
+	m_high.push_back(_point.high);
+	m_low.push_back(_point.low);
+	m_close.push_back(_point.close);
+	m_vol.push_back(_point.vol);
+}
+
+std::vector<s_graphPoint> CandleColumns::toPoints() const
+{
+	std::vector<s_graphPoint> _points;
+	_points.reserve(size());
+
+	for (size_t i = 0; i < size(); ++i)
+		_points.push_back({ m_time[i], m_open[i], m_high[i], m_low[i], m_close[i], m_vol[i] });
+
+	return _points;
+}
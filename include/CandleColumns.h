@@ -0,0 +1,196 @@
+/*
+	Copyright (c) 2019 Maciej Goncerz <https://github.com/Paurin1>.
+	Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+	CandleColumns class stores graph's points column by column: separate
+	contiguous arrays of time, open, high, low, close and volume, each one
+	aligned to 64 bytes. Indicators scanning one column read only the
+	memory they need, and loops over the arrays vectorise.
+
+	Indexing and iterating yield s_pointRef, a group of references into
+	the columns with the same members as s_graphPoint. Assigning to it
+	writes the columns, so reading members, assigning them and algorithms
+	like std::sort keep working without copying the points. It's returned
+	by value though, so a few forms written for std::vector<s_graphPoint>
+	don't compile anymore:
+		- for (auto& p : g->points), use auto, auto&& or const auto&
+		- comparators and callbacks taking s_graphPoint& or auto&, take
+		  const s_graphPoint& instead
+		- &g->points[i] and operator-> of the iterators
+*/
+
+#ifndef CANDLECOLUMNS_H
+#define CANDLECOLUMNS_H
+
+#include <cstddef>		// size_t, ptrdiff_t
+#include <vector>		// vector
+#include <iterator>		// random_access_iterator_tag
+
+// Allocator aligning columns to 64 bytes
+#include "AlignedAllocator.h"
+
+// Defined in PublicApiDataStructures.h, which stores graphs in CandleColumns
+struct s_graphPoint;
+
+class CandleColumns
+{
+public:
+	template <typename T>
+	using column = std::vector<T, AlignedAllocator<T>>;
+
+	/**
+		View of one point, members refer to the columns
+	*/
+	template <typename Long, typename Double>
+	struct s_basicPointRef
+	{
+		Long& time;
+		Double& open;
+		Double& high;
+		Double& low;
+		Double& close;
+		Double& vol;
+
+		/**
+			Copies the point out of the columns
+		*/
+		operator s_graphPoint() const;
+
+		/**
+			Writes values of another point into the columns, references stay where they were
+		*/
+		s_basicPointRef& operator=(const s_basicPointRef& _other)
+		{
+			time = _other.time;
+			open = _other.open;
+			high = _other.high;
+			low = _other.low;
+			close = _other.close;
+			vol = _other.vol;
+			return *this;
+		}
+
+		/**
+			Writes a point into the columns
+		*/
+		s_basicPointRef& operator=(const s_graphPoint& _point);
+	};
+
+	typedef s_basicPointRef<long, double> s_pointRef;
+	typedef s_basicPointRef<const long, const double> s_constPointRef;
+
+	/**
+		Random access iterator yielding point views by value
+	*/
+	template <typename Columns, typename Reference>
+	class basic_iterator
+	{
+	public:
+		typedef std::random_access_iterator_tag iterator_category;
+		typedef s_graphPoint value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef Reference reference;
+		typedef void pointer;
+
+		basic_iterator(Columns* _columns, size_t _index) : m_columns(_columns), m_index(_index) { }
+
+		Reference operator*() const							{ return (*m_columns)[m_index]; }
+		Reference operator[](difference_type _offset) const	{ return (*m_columns)[m_index + _offset]; }
+
+		basic_iterator& operator++()						{ ++m_index; return *this; }
+		basic_iterator& operator--()						{ --m_index; return *this; }
+		basic_iterator operator++(int)						{ basic_iterator _copy(*this); ++m_index; return _copy; }
+		basic_iterator operator--(int)						{ basic_iterator _copy(*this); --m_index; return _copy; }
+		basic_iterator& operator+=(difference_type _offset)	{ m_index += _offset; return *this; }
+		basic_iterator& operator-=(difference_type _offset)	{ m_index -= _offset; return *this; }
+		basic_iterator operator+(difference_type _offset) const	{ return basic_iterator(m_columns, m_index + _offset); }
+		basic_iterator operator-(difference_type _offset) const	{ return basic_iterator(m_columns, m_index - _offset); }
+
+		difference_type operator-(const basic_iterator& _other) const { return static_cast<difference_type>(m_index) - static_cast<difference_type>(_other.m_index); }
+
+		bool operator==(const basic_iterator& _other) const	{ return m_index == _other.m_index; }
+		bool operator!=(const basic_iterator& _other) const	{ return m_index != _other.m_index; }
+		bool operator<(const basic_iterator& _other) const	{ return m_index < _other.m_index; }
+		bool operator>(const basic_iterator& _other) const	{ return m_index > _other.m_index; }
+		bool operator<=(const basic_iterator& _other) const	{ return m_index <= _other.m_index; }
+		bool operator>=(const basic_iterator& _other) const	{ return m_index >= _other.m_index; }
+
+		friend basic_iterator operator+(difference_type _offset, const basic_iterator& _iterator) { return _iterator + _offset; }
+
+	private:
+		Columns* m_columns;
+		size_t m_index;
+	};
+
+	typedef basic_iterator<CandleColumns, s_pointRef> iterator;
+	typedef basic_iterator<const CandleColumns, s_constPointRef> const_iterator;
+
+	size_t size() const		{ return m_time.size(); }
+	bool empty() const		{ return m_time.empty(); }
+
+	/**
+		Reserves memory for given number of points in every column
+	*/
+	void reserve(size_t _count);
+
+	/**
+		Removes every point, memory is kept for reuse
+	*/
+	void clear();
+
+	/**
+		Appends a point, each value to its column
+	*/
+	void push_back(const s_graphPoint& _point);
+
+	s_pointRef operator[](size_t _index)
+	{
+		return { m_time[_index], m_open[_index], m_high[_index], m_low[_index], m_close[_index], m_vol[_index] };
+	}
+
+	s_constPointRef operator[](size_t _index) const
+	{
+		return { m_time[_index], m_open[_index], m_high[_index], m_low[_index], m_close[_index], m_vol[_index] };
+	}
+
+	s_pointRef front()				{ return (*this)[0]; }
+	s_constPointRef front() const	{ return (*this)[0]; }
+	s_pointRef back()				{ return (*this)[size() - 1]; }
+	s_constPointRef back() const	{ return (*this)[size() - 1]; }
+
+	iterator begin()				{ return iterator(this, 0); }
+	iterator end()					{ return iterator(this, size()); }
+	const_iterator begin() const	{ return const_iterator(this, 0); }
+	const_iterator end() const		{ return const_iterator(this, size()); }
+
+	/*
+		Columns, every one as long as size() and starting at a 64-byte boundary
+	*/
+
+	const column<long>& time() const	{ return m_time; }
+	const column<double>& open() const	{ return m_open; }
+	const column<double>& high() const	{ return m_high; }
+	const column<double>& low() const	{ return m_low; }
+	const column<double>& close() const	{ return m_close; }
+	const column<double>& vol() const	{ return m_vol; }
+
+	/**
+		Copies points into the former array of structures
+	*/
+	std::vector<s_graphPoint> toPoints() const;
+
+private:
+	column<long> m_time;
+	column<double> m_open;
+	column<double> m_high;
+	column<double> m_low;
+	column<double> m_close;
+	column<double> m_vol;
+};
+
+/**
+	Exchanges values of two points, used by algorithms that reorder the columns
+*/
+void swap(CandleColumns::s_pointRef _a, CandleColumns::s_pointRef _b);
+
+#endif
@@ -0,0 +1,159 @@
+/*
+	Copyright (c) 2019 Maciej Goncerz <https://github.com/Paurin1>.
+	Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+	More detailed descriptions are in CommandLimiter.h file.
+*/
+
+#include "CommandLimiter.h"
+
+#include <unordered_map>	// unordered_map
+#include <algorithm>		// min, max
+#include <thread>			// sleep_for
+
+namespace
+{
+	// longest waiting time after error 506 when the window's end is not known
+	const std::chrono::seconds max_backoff(60);
+
+	// part of remaining commands that may be sent at once, the rest is spread evenly
+	const double burst_fraction = 0.1;
+
+	std::time_t currentTime()
+	{
+		return std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+	}
+}
+
+CommandLimiter::CommandLimiter() : m_used(0), m_allowed(0), m_expires(0), m_backoff(1), m_pacer(1, 1)
+{ }
+
+std::shared_ptr<CommandLimiter> CommandLimiter::forKey(const std::string& _publicKey)
+{
+	static std::unordered_map<std::string, std::shared_ptr<CommandLimiter>> _limiters;
+	static std::mutex _mutex;
+
+	std::lock_guard<std::mutex> _lock(_mutex);
+
+	std::shared_ptr<CommandLimiter>& _limiter = _limiters[_publicKey];
+	if (!_limiter)
+		_limiter = std::make_shared<CommandLimiter>();
+
+	return _limiter;
+}
+
+std::chrono::milliseconds CommandLimiter::reserve()
+{
+	std::lock_guard<std::mutex> _lock(m_mutex);
+
+	std::time_t _now = currentTime();
+	f_expire(_now);
+
+	// nothing is known before the first response, commands are not limited
+	if (m_allowed <= 0)
+		return std::chrono::milliseconds(0);
+
+	if (m_used >= m_allowed)
+	{
+		// wait for the window to expire, a bit more since the API's clock may be late
+		if (m_expires > _now)
+			return std::chrono::seconds(m_expires - _now) + std::chrono::milliseconds(500);
+
+		return m_backoff;
+	}
+
+	std::chrono::milliseconds _wait = m_pacer.waitTime();
+	if (_wait.count() > 0 || !m_pacer.tryAcquire())
+		return std::max(_wait, std::chrono::milliseconds(1));
+
+	++m_used;
+	return std::chrono::milliseconds(0);
+}
+
+void CommandLimiter::acquire()
+{
+	while (true)
+	{
+		std::chrono::milliseconds _wait = reserve();
+
+		if (_wait.count() == 0)
+			return;
+
+		std::this_thread::sleep_for(_wait);
+	}
+}
+
+void CommandLimiter::update(long _used, long _allowed, long _expires)
+{
+	std::lock_guard<std::mutex> _lock(m_mutex);
+
+	// commands run concurrently, a late response may describe a window that is already over
+	if (_expires < m_expires)
+		return;
+
+	// commands sent after the response was generated are not counted by the API yet
+	if (_expires == m_expires)
+		m_used = std::max(m_used, _used);
+	else
+		m_used = _used;
+
+	m_allowed = _allowed;
+	m_expires = _expires;
+	m_backoff = std::chrono::seconds(1);
+
+	// remaining commands are spread evenly until the window expires
+	double _remaining = static_cast<double>(std::max(0L, m_allowed - m_used));
+	double _seconds = static_cast<double>(std::max<std::time_t>(1, m_expires - currentTime()));
+
+	m_pacer.configure(_remaining / _seconds, std::max(1.0, _remaining * burst_fraction));
+}
+
+void CommandLimiter::exceeded()
+{
+	std::lock_guard<std::mutex> _lock(m_mutex);
+
+	std::time_t _now = currentTime();
+	m_used = std::max(m_used, std::max(m_allowed, 1L));
+
+	// without a known window the limiter backs off until a response tells more
+	if (m_expires <= _now)
+	{
+		m_allowed = std::max(m_allowed, 1L);
+		m_expires = _now + m_backoff.count();
+		m_backoff = std::min(m_backoff * 2, max_backoff);
+	}
+}
+
+long CommandLimiter::remaining()
+{
+	std::lock_guard<std::mutex> _lock(m_mutex);
+	f_expire(currentTime());
+
+	if (m_allowed <= 0)
+		return -1;
+
+	return std::max(0L, m_allowed - m_used);
+}
+
+long CommandLimiter::allowed()
+{
+	std::lock_guard<std::mutex> _lock(m_mutex);
+	return m_allowed;
+}
+
+std::time_t CommandLimiter::expires()
+{
+	std::lock_guard<std::mutex> _lock(m_mutex);
+	return m_expires;
+}
+
+void CommandLimiter::f_expire(std::time_t _now)
+{
+	if (m_expires == 0 || _now < m_expires)
+		return;
+
+	// the whole allowance is available again, the next response tells when it expires
+	m_used = 0;
+	m_expires = 0;
+	m_pacer.configure(static_cast<double>(m_allowed), std::max(1.0, m_allowed * burst_fraction));
+}
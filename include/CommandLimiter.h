@@ -0,0 +1,99 @@
+/*
+	Copyright (c) 2019 Maciej Goncerz <https://github.com/Paurin1>.
+	Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+	CommandLimiter class keeps private commands of one API key within the
+	limit reported by the API. Every response carries a "limit" object:
+	number of commands used and allowed in the current window and the time
+	the window expires. Commands left are spread evenly until then, with
+	some room for bursts, and when none are left the next command waits
+	for the window to expire instead of being rejected with error 506.
+
+	Limits are counted per key by the API, so BitmarketPrivate objects
+	using the same key share one limiter obtained from forKey().
+*/
+
+#ifndef COMMANDLIMITER_H
+#define COMMANDLIMITER_H
+
+#include <string>	// string
+#include <memory>	// shared_ptr
+#include <mutex>	// mutex, lock_guard
+#include <chrono>	// system_clock, milliseconds
+#include <ctime>	// time_t
+
+// Token bucket spreading commands over the window
+#include "RateLimiter.h"
+
+class CommandLimiter
+{
+public:
+	CommandLimiter();
+
+	CommandLimiter(const CommandLimiter&) = delete;
+	CommandLimiter& operator=(const CommandLimiter&) = delete;
+
+	/**
+		Returns limiter shared by every user of given public key
+	*/
+	static std::shared_ptr<CommandLimiter> forKey(const std::string& _publicKey);
+
+	/**
+		Reserves one command if it may be sent now
+
+		@return zero if the command has been reserved, otherwise time to wait before trying again
+	*/
+	std::chrono::milliseconds reserve();
+
+	/**
+		Blocks calling thread until a command may be sent and reserves it
+	*/
+	void acquire();
+
+	/**
+		Updates the limit with values from API's response, responses about an earlier window are ignored
+
+		@param _used number of commands used in the current window
+		@param _allowed number of commands allowed in the window
+		@param _expires time the window expires, seconds since Unix epoch
+	*/
+	void update(long _used, long _allowed, long _expires);
+
+	/**
+		Records error 506, nothing is sent until the window expires
+	*/
+	void exceeded();
+
+	/**
+		Returns number of commands that may be sent in the current window, -1 if not known yet
+	*/
+	long remaining();
+
+	/**
+		Returns number of commands allowed in the window, 0 if not known yet
+	*/
+	long allowed();
+
+	/**
+		Returns time the current window expires, 0 if not known
+	*/
+	std::time_t expires();
+
+private:
+	/**
+		Starts a new window if the current one has expired
+	*/
+	void f_expire(std::time_t _now);
+
+	long m_used;
+	long m_allowed;
+	std::time_t m_expires;
+
+	// waiting time after error 506 when the window's end is not known, doubled every time
+	std::chrono::seconds m_backoff;
+
+	RateLimiter m_pacer;
+	std::mutex m_mutex;
+};
+
+#endif
@@ -0,0 +1,301 @@
+/*
+	Copyright (c) 2019 Maciej Goncerz <https://github.com/Paurin1>.
+	Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+	More detailed descriptions are in Decimal.h file.
+*/
+
+#include "Decimal.h"
+
+#include <cmath>			// llround
+#include <limits>			// numeric_limits
+#include <unordered_map>	// unordered_map
+#include <mutex>			// mutex, lock_guard
+
+namespace
+{
+	const int64_t max_units = std::numeric_limits<int64_t>::max();
+	const int64_t min_units = std::numeric_limits<int64_t>::min();
+
+	// mantissa stops growing at 19 digits, so it never overflows
+	const uint64_t max_mantissa = 1000000000000000000ULL;
+
+	const uint64_t powers_of_10[] =
+	{
+		1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL,
+		1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+		100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL,
+		1000000000000000000ULL, 10000000000000000000ULL
+	};
+
+	std::unordered_map<std::string, s_marketPrecision> g_precisions;
+	std::mutex g_precisionsMutex;
+}
+
+Decimal Decimal::fromInteger(long long _value)
+{
+	if (_value > max_units / scale)
+		return Decimal(max_units);
+
+	if (_value < min_units / scale)
+		return Decimal(min_units);
+
+	return Decimal(static_cast<int64_t>(_value) * scale);
+}
+
+Decimal Decimal::fromDouble(double _value)
+{
+	double _units = _value * scale;
+
+	// 2^63 is the first double out of the range
+	if (!(_units < 9223372036854775808.0))
+		return Decimal(_units != _units ? 0 : max_units);
+
+	if (_units <= -9223372036854775808.0)
+		return Decimal(min_units);
+
+	return Decimal(std::llround(_units));
+}
+
+bool Decimal::parse(const char* _begin, const char* _end, Decimal& _value)
+{
+	const char* _current = _begin;
+	bool _negative = false;
+
+	if (_current != _end && (*_current == '-' || *_current == '+'))
+		_negative = *_current++ == '-';
+
+	uint64_t _mantissa = 0;
+	int _exponent = 0;
+	bool _anyDigit = false;
+
+	// digits that don't fit in the mantissa are only counted, they're far below the unit
+	for (; _current != _end && *_current >= '0' && *_current <= '9'; ++_current)
+	{
+		_anyDigit = true;
+
+		if (_mantissa < max_mantissa)
+			_mantissa = _mantissa * 10 + (*_current - '0');
+		else
+			++_exponent;
+	}
+
+	if (_current != _end && *_current == '.')
+	{
+		for (++_current; _current != _end && *_current >= '0' && *_current <= '9'; ++_current)
+		{
+			_anyDigit = true;
+
+			if (_mantissa < max_mantissa)
+			{
+				_mantissa = _mantissa * 10 + (*_current - '0');
+				--_exponent;
+			}
+		}
+	}
+
+	if (!_anyDigit)
+		return false;
+
+	if (_current != _end && (*_current == 'e' || *_current == 'E'))
+	{
+		++_current;
+
+		bool _negativeExponent = false;
+		if (_current != _end && (*_current == '-' || *_current == '+'))
+			_negativeExponent = *_current++ == '-';
+
+		if (_current == _end || *_current < '0' || *_current > '9')
+			return false;
+
+		int _written = 0;
+		for (; _current != _end && *_current >= '0' && *_current <= '9'; ++_current)
+		{
+			// anything this large is out of the range or rounds to 0 anyway
+			if (_written < 1000)
+				_written = _written * 10 + (*_current - '0');
+		}
+
+		_exponent += _negativeExponent ? -_written : _written;
+	}
+
+	if (_current != _end)
+		return false;
+
+	// move the decimal point to the unit
+	int _shift = _exponent + digits;
+
+	if (_shift > 0)
+	{
+		if (_mantissa != 0 && _shift > 19)
+			return false;
+
+		for (; _shift > 0 && _mantissa != 0; --_shift)
+		{
+			if (_mantissa > static_cast<uint64_t>(max_units) / 10)
+				return false;
+
+			_mantissa *= 10;
+		}
+	}
+	else if (_shift < 0)
+	{
+		if (_shift < -19)
+			_mantissa = 0;
+		else
+		{
+			uint64_t _divisor = powers_of_10[-_shift];
+			uint64_t _rest = _mantissa % _divisor;
+
+			_mantissa /= _divisor;
+
+			if (_rest >= _divisor - _rest)
+				++_mantissa;
+		}
+	}
+
+	if (_mantissa > static_cast<uint64_t>(max_units))
+		return false;
+
+	_value.m_units = _negative ? -static_cast<int64_t>(_mantissa) : static_cast<int64_t>(_mantissa);
+	return true;
+}
+
+bool Decimal::parse(const std::string& _text, Decimal& _value)
+{
+	return parse(_text.data(), _text.data() + _text.size(), _value);
+}
+
+Decimal Decimal::multiply(Decimal _a, Decimal _b)
+{
+#if defined(__SIZEOF_INT128__)
+	__int128 _product = static_cast<__int128>(_a.m_units) * _b.m_units;
+	__int128 _half = (_product < 0 ? -scale : scale) / 2;
+	__int128 _result = (_product + _half) / scale;
+
+	if (_result > max_units)
+		return Decimal(max_units);
+
+	if (_result < min_units)
+		return Decimal(min_units);
+
+	return Decimal(static_cast<int64_t>(_result));
+#else
+	// whole and fractional parts multiplied separately, exact while the result fits
+	int64_t _whole = _a.m_units / scale;
+	int64_t _fraction = _a.m_units % scale;
+
+	return Decimal(_whole * _b.m_units) + fromDouble(static_cast<double>(_fraction) * _b.m_units / scale / scale);
+#endif
+}
+
+double Decimal::toDouble() const
+{
+	// division keeps values like 0.1 as close as double allows
+	return static_cast<double>(m_units) / scale;
+}
+
+size_t Decimal::toChars(char* _buffer) const
+{
+	char* _current = _buffer;
+	uint64_t _magnitude = m_units < 0 ? 0 - static_cast<uint64_t>(m_units) : static_cast<uint64_t>(m_units);
+
+	if (m_units < 0)
+		*_current++ = '-';
+
+	// whole part, written backwards and reversed
+	uint64_t _whole = _magnitude / scale;
+	uint64_t _fraction = _magnitude % scale;
+	char* _start = _current;
+
+	do
+	{
+		*_current++ = static_cast<char>('0' + _whole % 10);
+		_whole /= 10;
+	} while (_whole);
+
+	for (char* _left = _start, *_right = _current - 1; _left < _right; ++_left, --_right)
+	{
+		char _swap = *_left;
+		*_left = *_right;
+		*_right = _swap;
+	}
+
+	if (_fraction)
+	{
+		int _length = digits;
+
+		while (_fraction % 10 == 0)
+		{
+			_fraction /= 10;
+			--_length;
+		}
+
+		*_current++ = '.';
+
+		for (int i = _length - 1; i >= 0; --i)
+		{
+			_current[i] = static_cast<char>('0' + _fraction % 10);
+			_fraction /= 10;
+		}
+
+		_current += _length;
+	}
+
+	return _current - _buffer;
+}
+
+std::string Decimal::toString() const
+{
+	char _buffer[max_chars];
+	return std::string(_buffer, toChars(_buffer));
+}
+
+Decimal Decimal::roundTo(Decimal _step, e_rounding _rounding) const
+{
+	if (_step.m_units <= 0)
+		return *this;
+
+	int64_t _steps = m_units / _step.m_units;
+	int64_t _rest = m_units % _step.m_units;
+
+	switch (_rounding)
+	{
+	case e_down:
+		if (_rest < 0)
+			--_steps;
+		break;
+
+	case e_up:
+		if (_rest > 0)
+			++_steps;
+		break;
+
+	default:
+		// compared without doubling the rest, which could overflow
+		if (_rest > 0 && _rest >= _step.m_units - _rest)
+			++_steps;
+		else if (_rest < 0 && -_rest >= _step.m_units + _rest)
+			--_steps;
+		break;
+	}
+
+	return Decimal(_steps * _step.m_units);
+}
+
+s_marketPrecision marketPrecision(const std::string& _market)
+{
+	std::lock_guard<std::mutex> _lock(g_precisionsMutex);
+
+	auto _found = g_precisions.find(_market);
+	if (_found != g_precisions.end())
+		return _found->second;
+
+	return { Decimal::fromUnits(1), Decimal::fromUnits(1) };
+}
+
+void marketPrecision(const std::string& _market, const s_marketPrecision& _precision)
+{
+	std::lock_guard<std::mutex> _lock(g_precisionsMutex);
+	g_precisions[_market] = _precision;
+}
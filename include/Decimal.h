@@ -0,0 +1,129 @@
+/*
+	Copyright (c) 2019 Maciej Goncerz <https://github.com/Paurin1>.
+	Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+	Decimal class is a fixed-point number: a 64-bit integer counting units
+	of 10^-8, the smallest amount Bitmarket uses. Values are parsed from
+	and formatted to decimal text exactly, so prices and amounts sent back
+	to the API are the same ones it sent, and comparing or adding them is
+	plain integer arithmetic.
+
+	Orders are limited by the market's tick (step of exchange rate) and lot
+	(step of amount). They are set per market with marketPrecision(), every
+	market uses the single unit until told otherwise.
+*/
+
+#ifndef DECIMAL_H
+#define DECIMAL_H
+
+#include <cstdint>	// int64_t
+#include <cstddef>	// size_t
+#include <string>	// string
+
+class Decimal
+{
+public:
+	enum e_rounding
+	{
+		e_nearest,	// half away from zero
+		e_down,		// towards negative infinity
+		e_up		// towards positive infinity
+	};
+
+	// number of digits after the decimal point
+	static constexpr int digits = 8;
+
+	// number of units in 1
+	static constexpr int64_t scale = 100000000;
+
+	// longest text toChars() writes, without terminating zero
+	static constexpr size_t max_chars = 21;
+
+	constexpr Decimal() : m_units(0) { }
+
+	/**
+		Creates decimal from number of 10^-8 units
+	*/
+	static constexpr Decimal fromUnits(int64_t _units) { return Decimal(_units); }
+
+	/**
+		Creates decimal from a whole number, saturated at the range's ends
+	*/
+	static Decimal fromInteger(long long _value);
+
+	/**
+		Creates decimal from double rounded to the nearest unit, saturated at the range's ends
+	*/
+	static Decimal fromDouble(double _value);
+
+	/**
+		Parses text like "-12.345", "1e-05" or "7", digits beyond the 8th place are rounded
+
+		@return false if the text is not a number or doesn't fit in the range
+	*/
+	static bool parse(const char* _begin, const char* _end, Decimal& _value);
+	static bool parse(const std::string& _text, Decimal& _value);
+
+	/**
+		Returns a*b rounded to the nearest unit
+	*/
+	static Decimal multiply(Decimal _a, Decimal _b);
+
+	constexpr int64_t units() const { return m_units; }
+
+	double toDouble() const;
+
+	/**
+		Writes the shortest text representing the value, without exponent and terminating zero
+
+		@param _buffer at least max_chars long
+		@return number of characters written
+	*/
+	size_t toChars(char* _buffer) const;
+
+	std::string toString() const;
+
+	/**
+		Rounds to a multiple of given step, the value is returned unchanged if the step is not positive
+	*/
+	Decimal roundTo(Decimal _step, e_rounding _rounding = e_nearest) const;
+
+	constexpr Decimal operator-() const { return Decimal(-m_units); }
+	constexpr Decimal operator+(Decimal _other) const { return Decimal(m_units + _other.m_units); }
+	constexpr Decimal operator-(Decimal _other) const { return Decimal(m_units - _other.m_units); }
+	Decimal& operator+=(Decimal _other) { m_units += _other.m_units; return *this; }
+	Decimal& operator-=(Decimal _other) { m_units -= _other.m_units; return *this; }
+
+	constexpr bool operator==(Decimal _other) const { return m_units == _other.m_units; }
+	constexpr bool operator!=(Decimal _other) const { return m_units != _other.m_units; }
+	constexpr bool operator<(Decimal _other) const { return m_units < _other.m_units; }
+	constexpr bool operator<=(Decimal _other) const { return m_units <= _other.m_units; }
+	constexpr bool operator>(Decimal _other) const { return m_units > _other.m_units; }
+	constexpr bool operator>=(Decimal _other) const { return m_units >= _other.m_units; }
+
+private:
+	explicit constexpr Decimal(int64_t _units) : m_units(_units) { }
+
+	int64_t m_units;
+};
+
+/**
+	Steps of exchange rate and amount accepted by a market
+*/
+struct s_marketPrecision
+{
+	Decimal tick;
+	Decimal lot;
+};
+
+/**
+	Returns precision of given market, single units if it has not been set
+*/
+s_marketPrecision marketPrecision(const std::string& _market);
+
+/**
+	Sets precision of given market, used by every thread
+*/
+void marketPrecision(const std::string& _market, const s_marketPrecision& _precision);
+
+#endif
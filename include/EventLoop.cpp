@@ -0,0 +1,110 @@
+/*
+	Copyright (c) 2019 Maciej Goncerz <https://github.com/Paurin1>.
+	Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+	More detailed descriptions are in EventLoop.h file.
+*/
+
+#include "EventLoop.h"
+
+EventLoop::EventLoop() : m_sequence(0), m_stopped(false)
+{ }
+
+void EventLoop::post(std::function<void()> _handler)
+{
+	{
+		std::lock_guard<std::mutex> _lock(m_mutex);
+		m_ready.push_back(std::move(_handler));
+	}
+
+	m_condition.notify_one();
+}
+
+void EventLoop::postAfter(std::chrono::milliseconds _delay, std::function<void()> _handler)
+{
+	{
+		std::lock_guard<std::mutex> _lock(m_mutex);
+		m_timers.push({ std::chrono::steady_clock::now() + _delay, m_sequence++, std::move(_handler) });
+	}
+
+	m_condition.notify_one();
+}
+
+void EventLoop::run()
+{
+	std::unique_lock<std::mutex> _lock(m_mutex);
+
+	while (!m_stopped)
+	{
+		f_moveDueTimers(std::chrono::steady_clock::now());
+
+		if (m_ready.empty())
+		{
+			// sleep until a handler is posted or the nearest timer is due
+			if (m_timers.empty())
+				m_condition.wait(_lock);
+			else
+				m_condition.wait_until(_lock, m_timers.top().due);
+
+			continue;
+		}
+
+		std::function<void()> _handler = std::move(m_ready.front());
+		m_ready.pop_front();
+
+		// handlers may post new ones so the lock is released while they run
+		_lock.unlock();
+		_handler();
+		_lock.lock();
+	}
+
+	// the loop can be run again later
+	m_stopped = false;
+}
+
+size_t EventLoop::poll()
+{
+	std::unique_lock<std::mutex> _lock(m_mutex);
+	f_moveDueTimers(std::chrono::steady_clock::now());
+
+	// handlers posted while polling are left for the next call
+	size_t _count = m_ready.size();
+
+	for (size_t i = 0; i < _count; ++i)
+	{
+		std::function<void()> _handler = std::move(m_ready.front());
+		m_ready.pop_front();
+
+		_lock.unlock();
+		_handler();
+		_lock.lock();
+	}
+
+	return _count;
+}
+
+void EventLoop::stop()
+{
+	{
+		std::lock_guard<std::mutex> _lock(m_mutex);
+		m_stopped = true;
+	}
+
+	m_condition.notify_all();
+}
+
+bool EventLoop::empty()
+{
+	std::lock_guard<std::mutex> _lock(m_mutex);
+	return m_ready.empty() && m_timers.empty();
+}
+
+void EventLoop::f_moveDueTimers(std::chrono::steady_clock::time_point _now)
+{
+	while (!m_timers.empty() && m_timers.top().due <= _now)
+	{
+		// priority_queue gives only const access to its top element
+		m_ready.push_back(std::move(const_cast<s_timer&>(m_timers.top()).handler));
+		m_timers.pop();
+	}
+}
@@ -0,0 +1,96 @@
+/*
+	Copyright (c) 2019 Maciej Goncerz <https://github.com/Paurin1>.
+	Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+	EventLoop class runs queued handlers and timers on a single thread.
+	Other threads (i.e. IoExecutor's workers finishing a request) post
+	handlers to it, so code driven by the loop never needs locking.
+	Coroutines from BitmarketCoroutines.h are resumed on it, but the loop
+	itself doesn't depend on the network and can be driven in tests.
+*/
+
+#ifndef EVENTLOOP_H
+#define EVENTLOOP_H
+
+#include <deque>				// deque
+#include <vector>				// vector
+#include <queue>				// priority_queue
+#include <mutex>				// mutex, unique_lock
+#include <condition_variable>	// condition_variable
+#include <functional>			// function
+#include <chrono>				// steady_clock, milliseconds
+
+class EventLoop
+{
+public:
+	EventLoop();
+
+	EventLoop(const EventLoop&) = delete;
+	EventLoop& operator=(const EventLoop&) = delete;
+
+	/**
+		Queues handler to be run by the loop, may be called from any thread
+
+		@param _handler function to be called on the loop's thread
+	*/
+	void post(std::function<void()> _handler);
+
+	/**
+		Queues handler to be run after given time, may be called from any thread
+
+		@param _delay time after which the handler becomes ready
+		@param _handler function to be called on the loop's thread
+	*/
+	void postAfter(std::chrono::milliseconds _delay, std::function<void()> _handler);
+
+	/**
+		Runs handlers until stop() is called, waits for new ones when the queue is empty
+	*/
+	void run();
+
+	/**
+		Runs handlers that are ready without waiting for new ones
+
+		@return number of handlers that have been run
+	*/
+	size_t poll();
+
+	/**
+		Makes run() return after the current handler, may be called from any thread
+	*/
+	void stop();
+
+	/**
+		Returns true when there are no queued handlers nor timers
+	*/
+	bool empty();
+
+private:
+	struct s_timer
+	{
+		std::chrono::steady_clock::time_point due;
+		unsigned long long sequence;
+		std::function<void()> handler;
+
+		// earlier timers have higher priority, equal ones keep posting order
+		bool operator<(const s_timer& _other) const
+		{
+			return due != _other.due ? due > _other.due : sequence > _other.sequence;
+		}
+	};
+
+	/**
+		Moves timers that are due into the queue of ready handlers
+	*/
+	void f_moveDueTimers(std::chrono::steady_clock::time_point _now);
+
+	std::deque<std::function<void()>> m_ready;
+	std::priority_queue<s_timer> m_timers;
+	unsigned long long m_sequence;
+	bool m_stopped;
+
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+};
+
+#endif
@@ -0,0 +1,415 @@
+/*
+	Copyright (c) 2019 Maciej Goncerz <https://github.com/Paurin1>.
+	Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+	More detailed descriptions are in HttpsConnectionPool.h file.
+*/
+
+#include "HttpsConnectionPool.h"
+
+#include <openssl/ssl.h>
+#include <openssl/bio.h>
+#include <openssl/x509v3.h>
+#include <openssl/err.h>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#else
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#endif
+
+// host used by Bitmarket API
+const std::string bitmarket_pool_host = "www.bitmarket.pl";
+
+namespace
+{
+	void configureSocket(int _fd, int _timeoutMs)
+	{
+		if (_fd < 0)
+			return;
+
+		// requests are small and latency matters more than packet count
+		int _noDelay = 1;
+		setsockopt(_fd, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&_noDelay), sizeof(_noDelay));
+
+		if (_timeoutMs <= 0)
+			return;
+
+#ifdef _WIN32
+		DWORD _timeout = _timeoutMs;
+#else
+		timeval _timeout;
+		_timeout.tv_sec = _timeoutMs / 1000;
+		_timeout.tv_usec = (_timeoutMs % 1000) * 1000;
+#endif
+
+		setsockopt(_fd, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&_timeout), sizeof(_timeout));
+		setsockopt(_fd, SOL_SOCKET, SO_SNDTIMEO, reinterpret_cast<const char*>(&_timeout), sizeof(_timeout));
+	}
+
+	/**
+		Checks without blocking whether socket has anything to read. An idle
+		keep-alive connection must not, otherwise the server has closed it.
+	*/
+	bool socketReadable(int _fd)
+	{
+#ifdef _WIN32
+		fd_set _set;
+		FD_ZERO(&_set);
+		FD_SET(static_cast<SOCKET>(_fd), &_set);
+		timeval _timeout = { 0, 0 };
+		return select(0, &_set, nullptr, nullptr, &_timeout) != 0;
+#else
+		pollfd _poll;
+		_poll.fd = _fd;
+		_poll.events = POLLIN;
+		_poll.revents = 0;
+		return poll(&_poll, 1, 0) != 0;
+#endif
+	}
+
+	/**
+		Waits until socket being connected without blocking becomes writable,
+		that is until the connection has been established or has failed
+	*/
+	bool socketWritable(int _fd, int _timeoutMs)
+	{
+#ifdef _WIN32
+		fd_set _set;
+		fd_set _failed;
+		FD_ZERO(&_set);
+		FD_ZERO(&_failed);
+		FD_SET(static_cast<SOCKET>(_fd), &_set);
+		FD_SET(static_cast<SOCKET>(_fd), &_failed);
+		timeval _timeout = { _timeoutMs / 1000, (_timeoutMs % 1000) * 1000 };
+		// failed connection attempts are reported as exceptions on Windows
+		return select(0, nullptr, &_set, &_failed, _timeoutMs > 0 ? &_timeout : nullptr) > 0;
+#else
+		pollfd _poll;
+		_poll.fd = _fd;
+		_poll.events = POLLOUT;
+		_poll.revents = 0;
+		return poll(&_poll, 1, _timeoutMs > 0 ? _timeoutMs : -1) > 0;
+#endif
+	}
+
+	/**
+		Establishes TCP connection of a connect BIO, waiting at most _timeoutMs for it
+
+		@return false if the connection could not be established in time
+	*/
+	bool connectSocket(BIO* _bio, int _timeoutMs)
+	{
+		int _fd = -1;
+		BIO_set_nbio(_bio, 1);
+
+		while (BIO_do_connect(_bio) <= 0)
+		{
+			BIO_get_fd(_bio, &_fd);
+
+			if (!BIO_should_retry(_bio) || _fd < 0 || !socketWritable(_fd, _timeoutMs))
+				return false;
+		}
+
+		// from now on socket blocks, for at most the time set by configureSocket()
+		BIO_get_fd(_bio, &_fd);
+		return _fd >= 0 && BIO_socket_nbio(_fd, 0) != 0;
+	}
+
+	/**
+		Reads without blocking records that made an idle connection readable.
+		TLS 1.3 servers send session tickets after the handshake, they carry
+		no data and leave the connection usable.
+
+		@return true if there was nothing but such records to read
+	*/
+	bool onlyHandshakeRecords(SSL* _ssl, int _fd)
+	{
+		char _byte;
+
+		ERR_clear_error();
+		BIO_socket_nbio(_fd, 1);
+		int _read = SSL_peek(_ssl, &_byte, 1);
+		int _error = SSL_get_error(_ssl, _read);
+		BIO_socket_nbio(_fd, 0);
+
+		// data, EOF or an alert mean the connection can't be used for the next request
+		return _read <= 0 && _error == SSL_ERROR_WANT_READ;
+	}
+}
+
+HttpsConnectionPool::HttpsConnectionPool(std::string _host, std::string _port, size_t _maxSize, int _idleTimeoutMs)
+	:
+	m_host(_host),
+	m_port(_port),
+	m_maxSize(_maxSize),
+	m_idleTimeoutMs(_idleTimeoutMs),
+	m_timeoutMs(10000)
+{
+	// one context is shared by every connection made by this pool
+	SSL_CTX* _context = SSL_CTX_new(TLS_client_method());
+
+	if (_context)
+	{
+		SSL_CTX_set_default_verify_paths(_context);
+		SSL_CTX_set_verify(_context, SSL_VERIFY_PEER, nullptr);
+		SSL_CTX_set_min_proto_version(_context, TLS1_2_VERSION);
+
+		m_sslContext.reset(_context, SSL_CTX_free);
+	}
+}
+
+HttpsConnectionPool::~HttpsConnectionPool()
+{
+	for (auto& _connection : m_idle)
+		BIO_free_all(_connection.bio);
+}
+
+std::shared_ptr<HttpsConnectionPool> HttpsConnectionPool::shared()
+{
+	static std::shared_ptr<HttpsConnectionPool> _shared = std::make_shared<HttpsConnectionPool>(bitmarket_pool_host);
+	return _shared;
+}
+
+bio_st* HttpsConnectionPool::acquire(bool& _reused)
+{
+	std::vector<bio_st*> _stale;
+	bio_st* _bio = nullptr;
+
+	{
+		std::lock_guard<std::mutex> _lock(m_mutex);
+		auto _now = std::chrono::steady_clock::now();
+
+		// take the most recently used connection, drop every unhealthy one on the way
+		while (!m_idle.empty() && !_bio)
+		{
+			s_connection _connection = m_idle.back();
+			m_idle.pop_back();
+
+			if (f_healthy(_connection, _now))
+				_bio = _connection.bio;
+			else
+				_stale.push_back(_connection.bio);
+		}
+	}
+
+	for (auto _connection : _stale)
+		BIO_free_all(_connection);
+
+	_reused = _bio != nullptr;
+
+	// no warm connection available so establish a new one
+	if (!_bio)
+		_bio = f_connect();
+
+	return _bio;
+}
+
+void HttpsConnectionPool::release(bio_st* _connection, bool _reusable)
+{
+	if (!_connection)
+		return;
+
+	// TLS 1.3 session tickets arrive after the handshake, by now they have been read
+	f_rememberSession(_connection);
+
+	{
+		std::lock_guard<std::mutex> _lock(m_mutex);
+
+		if (_reusable && m_idle.size() < m_maxSize)
+		{
+			m_idle.push_back({ _connection, std::chrono::steady_clock::now() });
+			return;
+		}
+	}
+
+	BIO_free_all(_connection);
+}
+
+void HttpsConnectionPool::warmUp(size_t _count)
+{
+	for (size_t i = 0; i < _count && idleCount() < m_maxSize; ++i)
+	{
+		bio_st* _bio = f_connect();
+
+		if (!_bio)
+			return;
+
+		release(_bio, true);
+	}
+}
+
+void HttpsConnectionPool::prune()
+{
+	std::vector<bio_st*> _stale;
+
+	{
+		std::lock_guard<std::mutex> _lock(m_mutex);
+		auto _now = std::chrono::steady_clock::now();
+
+		for (size_t i = 0; i < m_idle.size(); )
+		{
+			if (f_healthy(m_idle[i], _now))
+			{
+				++i;
+				continue;
+			}
+
+			_stale.push_back(m_idle[i].bio);
+			m_idle.erase(m_idle.begin() + i);
+		}
+	}
+
+	for (auto _connection : _stale)
+		BIO_free_all(_connection);
+}
+
+void HttpsConnectionPool::maxSize(size_t _maxSize)
+{
+	std::vector<bio_st*> _excess;
+
+	{
+		std::lock_guard<std::mutex> _lock(m_mutex);
+		m_maxSize = _maxSize;
+
+		// close the oldest connections first
+		while (m_idle.size() > m_maxSize)
+		{
+			_excess.push_back(m_idle.front().bio);
+			m_idle.erase(m_idle.begin());
+		}
+	}
+
+	for (auto _connection : _excess)
+		BIO_free_all(_connection);
+}
+
+void HttpsConnectionPool::idleTimeout(int _idleTimeoutMs)
+{
+	std::lock_guard<std::mutex> _lock(m_mutex);
+	m_idleTimeoutMs = _idleTimeoutMs;
+}
+
+void HttpsConnectionPool::socketTimeout(int _timeoutMs)
+{
+	std::lock_guard<std::mutex> _lock(m_mutex);
+	m_timeoutMs = _timeoutMs;
+}
+
+size_t HttpsConnectionPool::idleCount()
+{
+	std::lock_guard<std::mutex> _lock(m_mutex);
+	return m_idle.size();
+}
+
+const std::string& HttpsConnectionPool::host() const
+{
+	return m_host;
+}
+
+bio_st* HttpsConnectionPool::f_connect()
+{
+	// check whether TLS context has been created correctly
+	if (!m_sslContext)
+		return nullptr;
+
+	int _timeoutMs;
+	std::shared_ptr<SSL_SESSION> _session;
+	{
+		std::lock_guard<std::mutex> _lock(m_mutex);
+		_timeoutMs = m_timeoutMs;
+		_session = m_session;
+	}
+
+	// TCP connection is established on its own, so that the timeout covers the TLS handshake as well
+	BIO* _tcp = BIO_new_connect((m_host + ":" + m_port).c_str());
+	if (!_tcp)
+		return nullptr;
+
+	if (!connectSocket(_tcp, _timeoutMs))
+	{
+		BIO_free_all(_tcp);
+		return nullptr;
+	}
+
+	int _fd = -1;
+	BIO_get_fd(_tcp, &_fd);
+	configureSocket(_fd, _timeoutMs);
+
+	BIO* _bio = BIO_new_ssl(m_sslContext.get(), 1);
+	if (!_bio)
+	{
+		BIO_free_all(_tcp);
+		return nullptr;
+	}
+
+	// freeing the TLS BIO frees the TCP one below it
+	BIO_push(_bio, _tcp);
+
+	SSL* _ssl = nullptr;
+	BIO_get_ssl(_bio, &_ssl);
+	SSL_set_mode(_ssl, SSL_MODE_AUTO_RETRY);
+
+	// SNI and certificate's host name verification
+	SSL_set_tlsext_host_name(_ssl, m_host.c_str());
+	SSL_set1_host(_ssl, m_host.c_str());
+
+	// resumed session skips certificate exchange, the server falls back to a full handshake if it has forgotten it
+	if (_session)
+		SSL_set_session(_ssl, _session.get());
+
+	if (BIO_do_handshake(_bio) <= 0 || SSL_get_verify_result(_ssl) != X509_V_OK)
+	{
+		BIO_free_all(_bio);
+		return nullptr;
+	}
+
+	f_rememberSession(_bio);
+
+	return _bio;
+}
+
+bool HttpsConnectionPool::f_healthy(const s_connection& _connection, std::chrono::steady_clock::time_point _now)
+{
+	// connections idle for too long are likely to be closed by the server any moment
+	if (_now - _connection.lastUsed > std::chrono::milliseconds(m_idleTimeoutMs))
+		return false;
+
+	int _fd = -1;
+	BIO_get_fd(_connection.bio, &_fd);
+
+	if (_fd < 0)
+		return false;
+
+	SSL* _ssl = nullptr;
+	BIO_get_ssl(_connection.bio, &_ssl);
+
+	if (!_ssl)
+		return !socketReadable(_fd);
+
+	// between requests there must be nothing to read - neither data nor EOF, only records without data
+	return SSL_pending(_ssl) == 0 && (!socketReadable(_fd) || onlyHandshakeRecords(_ssl, _fd));
+}
+
+void HttpsConnectionPool::f_rememberSession(bio_st* _connection)
+{
+	SSL* _ssl = nullptr;
+	BIO_get_ssl(_connection, &_ssl);
+
+	SSL_SESSION* _session = _ssl ? SSL_get1_session(_ssl) : nullptr;
+	if (!_session)
+		return;
+
+	if (!SSL_SESSION_is_resumable(_session))
+	{
+		SSL_SESSION_free(_session);
+		return;
+	}
+
+	std::lock_guard<std::mutex> _lock(m_mutex);
+	m_session.reset(_session, SSL_SESSION_free);
+}
@@ -0,0 +1,150 @@
+/*
+	Copyright (c) 2019 Maciej Goncerz <https://github.com/Paurin1>.
+	Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+	HttpsConnectionPool class keeps warm keep-alive TLS connections to a
+	single host, so requests made by HttpsNet don't pay for TCP and TLS
+	handshake every time. Connections that stayed idle for too long or
+	were closed by the server are dropped before they are handed out.
+	New connections resume the TLS session of the last one returned to the
+	pool, which skips certificate exchange and verification.
+
+	The pool is thread-safe. By default every BitmarketPublic and
+	BitmarketPrivate object shares one pool returned by shared().
+*/
+
+#ifndef HTTPSCONNECTIONPOOL_H
+#define HTTPSCONNECTIONPOOL_H
+
+#include <string>	// string
+#include <memory>	// shared_ptr
+#include <vector>	// vector
+#include <mutex>	// mutex, lock_guard
+#include <chrono>	// steady_clock
+
+// OpenSSL's types, kept opaque so that OpenSSL headers do not leak into user code
+struct ssl_ctx_st;
+struct ssl_session_st;
+struct bio_st;
+
+class HttpsConnectionPool
+{
+public:
+	/**
+		Creates pool of connections to a given host
+
+		@param _host name of the server, i.e. www.bitmarket.pl
+		@param _port TCP port of the server
+		@param _maxSize maximum number of idle connections kept open
+		@param _idleTimeoutMs idle connections older than this are closed instead of being reused
+	*/
+	HttpsConnectionPool(std::string _host, std::string _port = "443", size_t _maxSize = 4, int _idleTimeoutMs = 30000);
+
+	/**
+		Closes every idle connection
+	*/
+	~HttpsConnectionPool();
+
+	HttpsConnectionPool(const HttpsConnectionPool&) = delete;
+	HttpsConnectionPool& operator=(const HttpsConnectionPool&) = delete;
+
+	/**
+		Returns the pool shared by default by every BitmarketPublic and BitmarketPrivate object
+
+		@return pool of connections to Bitmarket API host
+	*/
+	static std::shared_ptr<HttpsConnectionPool> shared();
+
+	/**
+		Hands out connected and verified TLS connection, reuses an idle one if possible
+
+		@param _reused set to true when the connection has been used before
+		@return connection or nullptr if a new one could not be established
+	*/
+	bio_st* acquire(bool& _reused);
+
+	/**
+		Gives connection back to the pool
+
+		@param _connection connection obtained from acquire()
+		@param _reusable false if the connection must be closed, i.e. server asked for it or an error has occured
+	*/
+	void release(bio_st* _connection, bool _reusable);
+
+	/**
+		Opens connections in advance so that first requests don't wait for the handshake
+
+		@param _count number of connections to open, limited by the pool size
+	*/
+	void warmUp(size_t _count);
+
+	/**
+		Closes idle connections that expired or were closed by the server
+	*/
+	void prune();
+
+	/**
+		Changes maximum number of idle connections kept open
+	*/
+	void maxSize(size_t _maxSize);
+
+	/**
+		Changes time after which an idle connection is no longer reused
+	*/
+	void idleTimeout(int _idleTimeoutMs);
+
+	/**
+		Changes socket send/receive timeout of new connections
+	*/
+	void socketTimeout(int _timeoutMs);
+
+	/**
+		Returns number of idle connections currently kept open
+	*/
+	size_t idleCount();
+
+	/**
+		Name of the server connections are made to
+	*/
+	const std::string& host() const;
+
+private:
+	struct s_connection
+	{
+		bio_st* bio;
+		std::chrono::steady_clock::time_point lastUsed;
+	};
+
+	/**
+		Establishes new TLS connection and verifies server's certificate
+
+		@return connection or nullptr if an error has occured
+	*/
+	bio_st* f_connect();
+
+	/**
+		Checks whether an idle connection can be used for the next request
+
+		@return false if it has expired, was closed by the server or has unexpected data pending
+	*/
+	bool f_healthy(const s_connection& _connection, std::chrono::steady_clock::time_point _now);
+
+	/**
+		Keeps connection's TLS session to be resumed by the next new connection
+	*/
+	void f_rememberSession(bio_st* _connection);
+
+	const std::string m_host;
+	const std::string m_port;
+
+	size_t m_maxSize;
+	int m_idleTimeoutMs;
+	int m_timeoutMs;
+
+	std::shared_ptr<ssl_ctx_st> m_sslContext;
+	std::shared_ptr<ssl_session_st> m_session;
+	std::vector<s_connection> m_idle;
+	std::mutex m_mutex;
+};
+
+#endif
@@ -0,0 +1,468 @@
+/*
+	Copyright (c) 2019 Maciej Goncerz <https://github.com/Paurin1>.
+	Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+	More detailed descriptions are in HttpsNet.h file.
+*/
+
+#include "HttpsNet.h"
+
+#include <cstdlib>		// strtol, strtoull
+#include <cstdint>		// SIZE_MAX
+#include <cstring>		// memmove, memchr, memcmp
+#include <cctype>		// tolower
+#include <algorithm>	// max
+
+#include <openssl/bio.h>
+
+namespace
+{
+	// smallest amount of free space requested from the buffer before every read
+	const size_t read_chunk_size = 4096;
+
+	// larger chunks are treated as a broken response instead of being buffered
+	const unsigned long long max_chunk_size = 256ULL * 1024 * 1024;
+
+	/**
+		Compares header name with a lowercase string ignoring case
+	*/
+	bool equalsNoCase(const char* _text, size_t _length, const char* _lowercase)
+	{
+		size_t i = 0;
+
+		for (; i < _length && _lowercase[i]; ++i)
+		{
+			if (std::tolower(static_cast<unsigned char>(_text[i])) != _lowercase[i])
+				return false;
+		}
+
+		return i == _length && !_lowercase[i];
+	}
+
+	/**
+		Checks whether header value contains a lowercase token ignoring case
+	*/
+	bool containsNoCase(const char* _text, size_t _length, const char* _lowercase)
+	{
+		size_t _tokenLength = strlen(_lowercase);
+
+		for (size_t i = 0; i + _tokenLength <= _length; ++i)
+		{
+			if (equalsNoCase(_text + i, _tokenLength, _lowercase))
+				return true;
+		}
+
+		return false;
+	}
+
+	/**
+		Copies header value without surrounding whitespace
+	*/
+	std::string trimmed(const char* _text, size_t _length)
+	{
+		while (_length > 0 && (*_text == ' ' || *_text == '\t'))
+		{
+			++_text;
+			--_length;
+		}
+
+		while (_length > 0 && (_text[_length - 1] == ' ' || _text[_length - 1] == '\t'))
+			--_length;
+
+		return std::string(_text, _length);
+	}
+
+	/**
+		Reads HTTP response from a connected BIO into a ResponseBuffer. The body
+		is decoded in place (chunked encoding included) and the buffer's view is
+		set to it, so nothing is copied into intermediate strings.
+	*/
+	class ResponseReader
+	{
+	public:
+		ResponseReader(BIO* _bio, ResponseBuffer& _buffer, HttpsNet::s_validators* _validators) :
+			m_bio(_bio), m_buffer(_buffer), m_validators(_validators), m_status(0)
+		{ }
+
+		/**
+			Reads whole response, its body becomes the buffer's view
+
+			@param _keepAlive set to true when connection may be used for the next request
+			@return true if the response has been read completely
+		*/
+		bool read(bool& _keepAlive)
+		{
+			_keepAlive = false;
+			m_buffer.clear();
+
+			// read until the empty line ending headers
+			size_t _headersEnd;
+			if (!findInBuffer(0, "\r\n\r\n", _headersEnd))
+				return false;
+
+			const char* _raw = m_buffer.raw();
+			size_t _lineEnd;
+			findInBuffer(0, "\r\n", _lineEnd);
+
+			// status line, i.e. "HTTP/1.1 200 OK"
+			if (_lineEnd < 12 || memcmp(_raw, "HTTP/", 5) != 0)
+				return false;
+
+			m_status = static_cast<int>(std::strtol(_raw + 9, nullptr, 10));
+
+			// HTTP/1.1 connections are persistent unless stated otherwise
+			bool _persistent = memcmp(_raw, "HTTP/1.1", 8) == 0;
+			long _contentLength = -1;
+			bool _chunked = false;
+
+			// every header line is examined in place
+			for (size_t _line = _lineEnd + 2; _line < _headersEnd; _line = _lineEnd + 2)
+			{
+				findInBuffer(_line, "\r\n", _lineEnd);
+
+				const char* _colon = static_cast<const char*>(memchr(_raw + _line, ':', _lineEnd - _line));
+				if (!_colon)
+					continue;
+
+				size_t _nameLength = _colon - (_raw + _line);
+				const char* _value = _colon + 1;
+				size_t _valueLength = (_raw + _lineEnd) - _value;
+
+				if (equalsNoCase(_raw + _line, _nameLength, "content-length"))
+					_contentLength = std::strtol(_value, nullptr, 10);
+				else if (equalsNoCase(_raw + _line, _nameLength, "transfer-encoding"))
+					_chunked = containsNoCase(_value, _valueLength, "chunked");
+				else if (equalsNoCase(_raw + _line, _nameLength, "connection"))
+					_persistent = !containsNoCase(_value, _valueLength, "close");
+				else if (m_validators && equalsNoCase(_raw + _line, _nameLength, "etag"))
+					m_validators->etag = trimmed(_value, _valueLength);
+				else if (m_validators && equalsNoCase(_raw + _line, _nameLength, "last-modified"))
+					m_validators->lastModified = trimmed(_value, _valueLength);
+			}
+
+			size_t _bodyBegin = _headersEnd + 4;
+			bool _complete;
+
+			// these never have a body, whatever the headers say
+			if (m_status == 304 || m_status == 204 || (m_status >= 100 && m_status < 200))
+			{
+				m_buffer.view(_bodyBegin, _bodyBegin);
+				_complete = true;
+			}
+			else if (_chunked)
+				_complete = readChunked(_bodyBegin);
+			else if (_contentLength >= 0)
+			{
+				_complete = fillUntil(_bodyBegin + _contentLength);
+				m_buffer.view(_bodyBegin, _bodyBegin + _contentLength);
+			}
+			else
+			{
+				// no framing information, the server closes connection after the body
+				while (fill()) { }
+				m_buffer.view(_bodyBegin, m_buffer.filled());
+				_complete = true;
+				_persistent = false;
+			}
+
+			_keepAlive = _complete && _persistent;
+			return _complete;
+		}
+
+		/**
+			Status code of the response that has been read, i.e. 200
+		*/
+		int status() const
+		{
+			return m_status;
+		}
+
+	private:
+		/**
+			Reads next portion of data from the connection directly into the buffer
+
+			@return false when connection has been closed or an error has occured
+		*/
+		bool fill()
+		{
+			char* _free = m_buffer.prepare(read_chunk_size);
+			int _count = BIO_read(m_bio, _free, static_cast<int>(m_buffer.writable()));
+
+			if (_count <= 0)
+				return false;
+
+			m_buffer.commit(_count);
+			return true;
+		}
+
+		/**
+			Reads from the connection until at least _size bytes are in the buffer
+		*/
+		bool fillUntil(size_t _size)
+		{
+			while (m_buffer.filled() < _size)
+			{
+				if (!fill())
+					return false;
+			}
+
+			return true;
+		}
+
+		/**
+			Finds given text in the buffer, reads more data until it shows up
+
+			@param _from offset the search starts at
+			@param _text text to be found
+			@param _position offset of the found text
+		*/
+		bool findInBuffer(size_t _from, const char* _text, size_t& _position)
+		{
+			size_t _length = strlen(_text);
+
+			while (true)
+			{
+				const char* _raw = m_buffer.raw();
+
+				for (size_t i = _from; i + _length <= m_buffer.filled(); ++i)
+				{
+					if (memcmp(_raw + i, _text, _length) == 0)
+					{
+						_position = i;
+						return true;
+					}
+				}
+
+				// the text may begin in the part that has already been searched
+				if (m_buffer.filled() >= _length)
+					_from = std::max(_from, m_buffer.filled() - _length + 1);
+
+				if (!fill())
+					return false;
+			}
+		}
+
+		/**
+			Decodes chunked body by moving every chunk right after the previous one
+		*/
+		bool readChunked(size_t _bodyBegin)
+		{
+			size_t _read = _bodyBegin;
+			size_t _write = _bodyBegin;
+			size_t _lineEnd;
+
+			while (true)
+			{
+				// chunk size is hexadecimal and may be followed by extensions, the
+				// line always ends with CR so strtoull stops inside the buffer
+				if (!findInBuffer(_read, "\r\n", _lineEnd))
+					return false;
+
+				const char* _digits = m_buffer.raw() + _read;
+				char* _digitsEnd = nullptr;
+				unsigned long long _parsed = std::strtoull(_digits, &_digitsEnd, 16);
+				_read = _lineEnd + 2;
+
+				// a huge size would wrap the offsets below and move memory out of the buffer
+				if (_digitsEnd == _digits || _parsed > max_chunk_size || _parsed > SIZE_MAX - _read - 2)
+					return false;
+
+				size_t _size = static_cast<size_t>(_parsed);
+
+				if (_size == 0)
+				{
+					// skip trailers until the final empty line
+					while (true)
+					{
+						if (!findInBuffer(_read, "\r\n", _lineEnd))
+							return false;
+
+						if (_lineEnd == _read)
+							break;
+
+						_read = _lineEnd + 2;
+					}
+
+					m_buffer.view(_bodyBegin, _write);
+					return true;
+				}
+
+				// chunk data followed by CRLF
+				if (!fillUntil(_read + _size + 2))
+					return false;
+
+				memmove(m_buffer.raw() + _write, m_buffer.raw() + _read, _size);
+				_write += _size;
+				_read += _size + 2;
+			}
+		}
+
+		BIO* m_bio;
+		ResponseBuffer& m_buffer;
+		HttpsNet::s_validators* m_validators;
+		int m_status;
+	};
+}
+
+HttpsNet::HttpsNet() : HttpsNet(HttpsConnectionPool::shared())
+{ }
+
+HttpsNet::HttpsNet(std::string _host, std::string _port) : HttpsNet(std::make_shared<HttpsConnectionPool>(_host, _port))
+{ }
+
+HttpsNet::HttpsNet(std::shared_ptr<HttpsConnectionPool> _pool) : m_pool(_pool), m_buffers(ResponseBufferPool::shared())
+{ }
+
+std::shared_ptr<HttpsConnectionPool> HttpsNet::pool() const
+{
+	return m_pool;
+}
+
+void HttpsNet::buffers(std::shared_ptr<ResponseBufferPool> _buffers)
+{
+	m_buffers = _buffers;
+}
+
+std::string HttpsNet::get(std::string _url)
+{
+	std::shared_ptr<ResponseBuffer> _response = getBuffer(_url);
+	return _response ? _response->str() : std::string();
+}
+
+std::string HttpsNet::post(std::string _url, std::string _params, std::string _headers)
+{
+	std::shared_ptr<ResponseBuffer> _response = postBuffer(_url, _params, _headers);
+	return _response ? _response->str() : std::string();
+}
+
+std::shared_ptr<ResponseBuffer> HttpsNet::getBuffer(const std::string& _url)
+{
+	return f_request(
+		"GET " + _url + " HTTP/1.1\r\n"
+		"Host: " + m_pool->host() + "\r\n"
+		"Accept-Encoding: identity\r\n"
+		"Connection: keep-alive\r\n"
+		"\r\n", true);
+}
+
+std::shared_ptr<ResponseBuffer> HttpsNet::getBuffer(const std::string& _url, s_validators& _validators)
+{
+	std::string _request =
+		"GET " + _url + " HTTP/1.1\r\n"
+		"Host: " + m_pool->host() + "\r\n"
+		"Accept-Encoding: identity\r\n"
+		"Connection: keep-alive\r\n";
+
+	// the server answers 304 when neither of them has changed
+	if (!_validators.etag.empty())
+		_request += "If-None-Match: " + _validators.etag + "\r\n";
+
+	if (!_validators.lastModified.empty())
+		_request += "If-Modified-Since: " + _validators.lastModified + "\r\n";
+
+	_request += "\r\n";
+
+	return f_request(_request, true, &_validators);
+}
+
+std::shared_ptr<ResponseBuffer> HttpsNet::postBuffer(const std::string& _url, const std::string& _params, const std::string& _headers)
+{
+	std::string _request =
+		"POST " + _url + " HTTP/1.1\r\n"
+		"Host: " + m_pool->host() + "\r\n"
+		"Accept-Encoding: identity\r\n"
+		"Connection: keep-alive\r\n"
+		"Content-Type: application/x-www-form-urlencoded\r\n"
+		"Content-Length: " + std::to_string(_params.size()) + "\r\n";
+
+	// headers are passed in the same "Name=value&Name=value" form python script accepted
+	std::string::size_type _begin = 0;
+	while (_begin < _headers.size())
+	{
+		std::string::size_type _end = _headers.find('&', _begin);
+		if (_end == std::string::npos)
+			_end = _headers.size();
+
+		std::string::size_type _equals = _headers.find('=', _begin);
+		if (_equals != std::string::npos && _equals < _end)
+		{
+			_request.append(_headers, _begin, _equals - _begin);
+			_request += ": ";
+			_request.append(_headers, _equals + 1, _end - _equals - 1);
+			_request += "\r\n";
+		}
+
+		_begin = _end + 1;
+	}
+
+	_request += "\r\n";
+	_request += _params;
+
+	return f_request(_request, false);
+}
+
+std::shared_ptr<ResponseBuffer> HttpsNet::f_request(const std::string& _request, bool _repeatable, s_validators* _validators)
+{
+	std::shared_ptr<ResponseBuffer> _response = m_buffers->acquire();
+
+	// a reused connection may have been closed by the server in the meantime, then
+	// the request is repeated once on a fresh one
+	for (int _attempt = 0; _attempt < 2; ++_attempt)
+	{
+		bool _reused = false;
+		BIO* _bio = m_pool->acquire(_reused);
+
+		if (!_bio)
+			return nullptr;
+
+		bool _keepAlive = false;
+		bool _success = false;
+		int _status = 0;
+
+		// validators of a response are known only once it has been read completely
+		s_validators _received = { std::string(), std::string(), false };
+
+		int _written = BIO_write(_bio, _request.data(), static_cast<int>(_request.size()));
+
+		if (_written == static_cast<int>(_request.size()))
+		{
+			ResponseReader _reader(_bio, *_response, _validators ? &_received : nullptr);
+			_success = _reader.read(_keepAlive);
+			_status = _reader.status();
+		}
+
+		m_pool->release(_bio, _success && _keepAlive);
+
+		if (_success && _validators && _status == 304)
+		{
+			// 304 may omit validators that haven't changed
+			if (!_received.etag.empty())
+				_validators->etag = _received.etag;
+
+			if (!_received.lastModified.empty())
+				_validators->lastModified = _received.lastModified;
+
+			_validators->notModified = true;
+			return nullptr;
+		}
+
+		if (_success)
+		{
+			if (_validators)
+				*_validators = _received;
+
+			return _response;
+		}
+
+		if (!_reused)
+			break;
+
+		// a command that reached the server may have been executed even though the
+		// response was lost, sending it again would only get the tonce rejected; it's
+		// repeated only when nothing was written or the connection closed without a byte
+		if (!_repeatable && _written > 0 && (_written != static_cast<int>(_request.size()) || _response->filled() > 0))
+			break;
+	}
+
+	return nullptr;
+}
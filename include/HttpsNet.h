@@ -0,0 +1,135 @@
+/*
+	Copyright (c) 2019 Maciej Goncerz <https://github.com/Paurin1>.
+	Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+	HttpsNet class sends HTTPS requests to Bitmarket API from within the
+	process. It replaces the external python script used by PythonNet while
+	keeping the same get/post interface, so no child process is started and
+	no temporary file is written. TLS is provided by OpenSSL.
+
+	Connections are kept alive and reused through HttpsConnectionPool.
+	Responses are read into pooled ResponseBuffers, getBuffer/postBuffer
+	hand them to the caller without copying the body. A GET request may be
+	conditional, the server answers 304 without the body if the resource
+	hasn't changed since the response the caller already has.
+*/
+
+#ifndef HTTPSNET_H
+#define HTTPSNET_H
+
+#include <string>	// string
+#include <memory>	// shared_ptr
+
+// Pool of keep-alive connections to the API host
+#include "HttpsConnectionPool.h"
+
+// Reusable memory responses are read into
+#include "ResponseBuffer.h"
+
+class HttpsNet
+{
+public:
+	/**
+		Validators of a response, sent back to the server by a conditional request
+	*/
+	struct s_validators
+	{
+		std::string etag;			// ETag header, sent as If-None-Match
+		std::string lastModified;	// Last-Modified header, sent as If-Modified-Since
+		bool notModified;			// server answered 304, the resource hasn't changed
+	};
+
+	/**
+		Creates transport using the connection pool shared by every Bitmarket API object
+	*/
+	HttpsNet();
+
+	/**
+		Creates transport connected to a given host through its own connection pool
+
+		@param _host name of the server, i.e. www.bitmarket.pl
+		@param _port TCP port of the server, 443 by default
+	*/
+	HttpsNet(std::string _host, std::string _port = "443");
+
+	/**
+		Creates transport using given connection pool
+
+		@param _pool pool of connections, may be shared with other transports
+	*/
+	HttpsNet(std::shared_ptr<HttpsConnectionPool> _pool);
+
+	/**
+		Sends GET request to the server
+
+		@param _url path of the requested resource, i.e. /json/BTCPLN/ticker.json
+		@return body of the response or an empty string if an error has occured
+	*/
+	std::string get(std::string _url);
+
+	/**
+		Sends POST request to the server
+
+		@param _url path of the requested resource, i.e. /api2/
+		@param _params url-encoded body of the request
+		@param _headers additional headers in form of "Name1=value1&Name2=value2"
+		@return body of the response or an empty string if an error has occured
+	*/
+	std::string post(std::string _url, std::string _params, std::string _headers);
+
+	/**
+		Sends GET request to the server, the body is not copied
+
+		@param _url path of the requested resource, i.e. /json/BTCPLN/ticker.json
+		@return buffer holding body of the response or nullptr if an error has occured
+	*/
+	std::shared_ptr<ResponseBuffer> getBuffer(const std::string& _url);
+
+	/**
+		Sends conditional GET request to the server, the body is not copied
+
+		@param _url path of the requested resource, i.e. /json/BTCPLN/ticker.json
+		@param _validators validators of the response the caller has, empty ones are not sent;
+					replaced with those of the new response, notModified is set on 304
+		@return buffer holding body of the response or nullptr if an error has occured or the resource hasn't changed
+	*/
+	std::shared_ptr<ResponseBuffer> getBuffer(const std::string& _url, s_validators& _validators);
+
+	/**
+		Sends POST request to the server, the body is not copied
+
+		@param _url path of the requested resource, i.e. /api2/
+		@param _params url-encoded body of the request
+		@param _headers additional headers in form of "Name1=value1&Name2=value2"
+		@return buffer holding body of the response or nullptr if an error has occured
+	*/
+	std::shared_ptr<ResponseBuffer> postBuffer(const std::string& _url, const std::string& _params, const std::string& _headers);
+
+	/**
+		Returns connection pool used by this transport
+	*/
+	std::shared_ptr<HttpsConnectionPool> pool() const;
+
+	/**
+		Changes pool response buffers are taken from
+
+		@param _buffers pool of buffers, ResponseBufferPool::shared() is used by default
+	*/
+	void buffers(std::shared_ptr<ResponseBufferPool> _buffers);
+
+private:
+	/**
+		Sends complete HTTP request over a pooled connection and reads the response
+
+		@param _request serialized HTTP request including headers
+		@param _repeatable whether the request may be sent again after the server could have received it
+		@param _validators set to validators of the response, if not nullptr
+		@return buffer holding body of the response or nullptr if an error has occured or the server answered 304
+	*/
+	std::shared_ptr<ResponseBuffer> f_request(const std::string& _request, bool _repeatable, s_validators* _validators = nullptr);
+
+	std::shared_ptr<HttpsConnectionPool> m_pool;
+	std::shared_ptr<ResponseBufferPool> m_buffers;
+};
+
+#endif
@@ -0,0 +1,707 @@
+/*
+	Copyright (c) 2019 Maciej Goncerz <https://github.com/Paurin1>.
+	Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+	More detailed descriptions are in Indicators.h file.
+
+	Every loop over columns is a kernel with a standard and an AVX2 variant,
+	the set of kernels is picked on the first use. Rolling sums don't add up
+	whole windows: the sum moves by the value entering and the one leaving
+	the window, and it's summed from scratch again every resync_interval
+	values so rounding errors don't pile up. The AVX2 variant moves it by 4
+	values at once with a prefix sum inside the register.
+
+	Rolling minimum and maximum use van Herk/Gil-Werman algorithm: prefix
+	and suffix extremes of blocks as long as the period, every window is
+	covered by a suffix of one block and a prefix of the next one.
+
+	Rolling deviation doesn't use sums of squares, they cancel out badly
+	for prices far from 0. It moves the window's mean, kept as a sum of two
+	doubles, and squared deviations around it, and computes both again
+	every resync_interval windows.
+*/
+
+#include "Indicators.h"
+
+#include <cstdint>		// uint32_t, uint64_t
+#include <cmath>		// sqrt
+#include <limits>		// numeric_limits
+#include <vector>		// vector
+#include <algorithm>	// min, max, sort, is_sorted
+
+#if defined(__x86_64__) || defined(__amd64__) || defined(_M_X64)
+#define INDICATORS_X86_DISPATCH
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>		// __cpuidex, _xgetbv
+#endif
+#endif
+
+#if defined(__GNUC__)
+#define INDICATORS_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define INDICATORS_TARGET_AVX2
+#endif
+
+namespace
+{
+	const double not_a_number = std::numeric_limits<double>::quiet_NaN();
+
+	// running sums are summed from scratch at least this often
+	const size_t resync_interval = 1024;
+
+	/**
+		Loops having standard and AVX2 variants
+	*/
+	struct s_kernels
+	{
+		// _result[i] = _scale * sum of _values[i - _period + 1 .. i], for i >= _period - 1
+		void (*windowSum)(const double* _values, size_t _count, size_t _period, double _scale, double* _result);
+
+		// _result[i] = extreme of _suffix[i - _period + 1] and _result[i], for i >= _period - 1
+		void (*combineMinimum)(const double* _suffix, size_t _count, size_t _period, double* _result);
+		void (*combineMaximum)(const double* _suffix, size_t _count, size_t _period, double* _result);
+
+		// _result[i] = _values[i] / _values[i - 1] - 1, for i >= 1
+		void (*returns)(const double* _values, size_t _count, double* _result);
+
+		double (*sum)(const double* _values, size_t _count);
+
+		// sum of (_values[i] - _mean)^2
+		double (*squaredDeviations)(const double* _values, size_t _count, double _mean);
+
+		// sums of _prices[i] * _volumes[i] and of _volumes[i]
+		void (*weightedSums)(const double* _prices, const double* _volumes, size_t _count, double& _sumPV, double& _sumV);
+
+		// _result[i] = (_high[i] + _low[i] + _close[i]) / 3 * _volume[i]
+		void (*typicalValues)(const double* _high, const double* _low, const double* _close, const double* _volume, size_t _count, double* _result);
+
+		const char* name;
+	};
+
+	/*
+		Standard kernels
+	*/
+
+	void windowSumStandard(const double* _values, size_t _count, size_t _period, double _scale, double* _result)
+	{
+		size_t i = _period - 1;
+
+		while (i < _count)
+		{
+			double _sum = 0;
+			for (size_t j = i + 1 - _period; j <= i; ++j)
+				_sum += _values[j];
+
+			_result[i] = _sum * _scale;
+
+			size_t _stop = std::min(_count, i + 1 + std::max(resync_interval, _period));
+
+			for (++i; i < _stop; ++i)
+			{
+				_sum += _values[i] - _values[i - _period];
+				_result[i] = _sum * _scale;
+			}
+		}
+	}
+
+	void combineMinimumStandard(const double* _suffix, size_t _count, size_t _period, double* _result)
+	{
+		for (size_t i = _period - 1; i < _count; ++i)
+			_result[i] = std::min(_suffix[i + 1 - _period], _result[i]);
+	}
+
+	void combineMaximumStandard(const double* _suffix, size_t _count, size_t _period, double* _result)
+	{
+		for (size_t i = _period - 1; i < _count; ++i)
+			_result[i] = std::max(_suffix[i + 1 - _period], _result[i]);
+	}
+
+	void returnsStandard(const double* _values, size_t _count, double* _result)
+	{
+		for (size_t i = 1; i < _count; ++i)
+			_result[i] = _values[i] / _values[i - 1] - 1;
+	}
+
+	double sumStandard(const double* _values, size_t _count)
+	{
+		double _sum = 0;
+
+		for (size_t i = 0; i < _count; ++i)
+			_sum += _values[i];
+
+		return _sum;
+	}
+
+	double squaredDeviationsStandard(const double* _values, size_t _count, double _mean)
+	{
+		double _sum = 0;
+
+		for (size_t i = 0; i < _count; ++i)
+			_sum += (_values[i] - _mean) * (_values[i] - _mean);
+
+		return _sum;
+	}
+
+	void weightedSumsStandard(const double* _prices, const double* _volumes, size_t _count, double& _sumPV, double& _sumV)
+	{
+		_sumPV = 0;
+		_sumV = 0;
+
+		for (size_t i = 0; i < _count; ++i)
+		{
+			_sumPV += _prices[i] * _volumes[i];
+			_sumV += _volumes[i];
+		}
+	}
+
+	void typicalValuesStandard(const double* _high, const double* _low, const double* _close, const double* _volume, size_t _count, double* _result)
+	{
+		for (size_t i = 0; i < _count; ++i)
+			_result[i] = (_high[i] + _low[i] + _close[i]) * (1.0 / 3) * _volume[i];
+	}
+
+	const s_kernels standard_kernels =
+	{
+		windowSumStandard, combineMinimumStandard, combineMaximumStandard, returnsStandard, sumStandard,
+		squaredDeviationsStandard, weightedSumsStandard, typicalValuesStandard, "standard"
+	};
+
+#ifdef INDICATORS_X86_DISPATCH
+	/*
+		AVX2 kernels, 4 doubles per register
+	*/
+
+	INDICATORS_TARGET_AVX2 inline double horizontalSum(__m256d _vector)
+	{
+		__m128d _sum = _mm_add_pd(_mm256_castpd256_pd128(_vector), _mm256_extractf128_pd(_vector, 1));
+		return _mm_cvtsd_f64(_mm_add_sd(_sum, _mm_unpackhi_pd(_sum, _sum)));
+	}
+
+	INDICATORS_TARGET_AVX2 void windowSumAvx2(const double* _values, size_t _count, size_t _period, double _scale, double* _result)
+	{
+		const __m256d _zero = _mm256_setzero_pd();
+		const __m256d _scales = _mm256_set1_pd(_scale);
+		size_t i = _period - 1;
+
+		while (i < _count)
+		{
+			double _sum = 0;
+			for (size_t j = i + 1 - _period; j <= i; ++j)
+				_sum += _values[j];
+
+			_result[i] = _sum * _scale;
+
+			size_t _stop = std::min(_count, i + 1 + std::max(resync_interval, _period));
+			__m256d _carry = _mm256_set1_pd(_sum);
+
+			for (++i; i + 4 <= _stop; i += 4)
+			{
+				// changes of the sum, then their prefix sums: d0, d0+d1, d0+d1+d2, d0+d1+d2+d3
+				__m256d _change = _mm256_sub_pd(_mm256_loadu_pd(_values + i), _mm256_loadu_pd(_values + i - _period));
+				_change = _mm256_add_pd(_change, _mm256_blend_pd(_mm256_permute4x64_pd(_change, 0x90), _zero, 0x1));
+				_change = _mm256_add_pd(_change, _mm256_permute2f128_pd(_change, _change, 0x08));
+
+				__m256d _sums = _mm256_add_pd(_carry, _change);
+				_mm256_storeu_pd(_result + i, _mm256_mul_pd(_sums, _scales));
+
+				// the last sum goes to every lane
+				_carry = _mm256_permute4x64_pd(_sums, 0xff);
+			}
+
+			_sum = _mm256_cvtsd_f64(_carry);
+
+			for (; i < _stop; ++i)
+			{
+				_sum += _values[i] - _values[i - _period];
+				_result[i] = _sum * _scale;
+			}
+		}
+	}
+
+	INDICATORS_TARGET_AVX2 void combineMinimumAvx2(const double* _suffix, size_t _count, size_t _period, double* _result)
+	{
+		size_t i = _period - 1;
+
+		for (; i + 4 <= _count; i += 4)
+			_mm256_storeu_pd(_result + i, _mm256_min_pd(_mm256_loadu_pd(_suffix + i + 1 - _period), _mm256_loadu_pd(_result + i)));
+
+		for (; i < _count; ++i)
+			_result[i] = std::min(_suffix[i + 1 - _period], _result[i]);
+	}
+
+	INDICATORS_TARGET_AVX2 void combineMaximumAvx2(const double* _suffix, size_t _count, size_t _period, double* _result)
+	{
+		size_t i = _period - 1;
+
+		for (; i + 4 <= _count; i += 4)
+			_mm256_storeu_pd(_result + i, _mm256_max_pd(_mm256_loadu_pd(_suffix + i + 1 - _period), _mm256_loadu_pd(_result + i)));
+
+		for (; i < _count; ++i)
+			_result[i] = std::max(_suffix[i + 1 - _period], _result[i]);
+	}
+
+	INDICATORS_TARGET_AVX2 void returnsAvx2(const double* _values, size_t _count, double* _result)
+	{
+		const __m256d _one = _mm256_set1_pd(1);
+		size_t i = 1;
+
+		for (; i + 4 <= _count; i += 4)
+			_mm256_storeu_pd(_result + i, _mm256_sub_pd(_mm256_div_pd(_mm256_loadu_pd(_values + i), _mm256_loadu_pd(_values + i - 1)), _one));
+
+		for (; i < _count; ++i)
+			_result[i] = _values[i] / _values[i - 1] - 1;
+	}
+
+	INDICATORS_TARGET_AVX2 double sumAvx2(const double* _values, size_t _count)
+	{
+		// independent accumulators hide latency of additions
+		__m256d _sum0 = _mm256_setzero_pd();
+		__m256d _sum1 = _mm256_setzero_pd();
+		__m256d _sum2 = _mm256_setzero_pd();
+		__m256d _sum3 = _mm256_setzero_pd();
+		size_t i = 0;
+
+		for (; i + 16 <= _count; i += 16)
+		{
+			_sum0 = _mm256_add_pd(_sum0, _mm256_loadu_pd(_values + i));
+			_sum1 = _mm256_add_pd(_sum1, _mm256_loadu_pd(_values + i + 4));
+			_sum2 = _mm256_add_pd(_sum2, _mm256_loadu_pd(_values + i + 8));
+			_sum3 = _mm256_add_pd(_sum3, _mm256_loadu_pd(_values + i + 12));
+		}
+
+		for (; i + 4 <= _count; i += 4)
+			_sum0 = _mm256_add_pd(_sum0, _mm256_loadu_pd(_values + i));
+
+		double _sum = horizontalSum(_mm256_add_pd(_mm256_add_pd(_sum0, _sum1), _mm256_add_pd(_sum2, _sum3)));
+
+		for (; i < _count; ++i)
+			_sum += _values[i];
+
+		return _sum;
+	}
+
+	INDICATORS_TARGET_AVX2 double squaredDeviationsAvx2(const double* _values, size_t _count, double _mean)
+	{
+		const __m256d _means = _mm256_set1_pd(_mean);
+		__m256d _sum0 = _mm256_setzero_pd();
+		__m256d _sum1 = _mm256_setzero_pd();
+		size_t i = 0;
+
+		for (; i + 8 <= _count; i += 8)
+		{
+			__m256d _deviation0 = _mm256_sub_pd(_mm256_loadu_pd(_values + i), _means);
+			__m256d _deviation1 = _mm256_sub_pd(_mm256_loadu_pd(_values + i + 4), _means);
+			_sum0 = _mm256_add_pd(_sum0, _mm256_mul_pd(_deviation0, _deviation0));
+			_sum1 = _mm256_add_pd(_sum1, _mm256_mul_pd(_deviation1, _deviation1));
+		}
+
+		double _sum = horizontalSum(_mm256_add_pd(_sum0, _sum1));
+
+		for (; i < _count; ++i)
+			_sum += (_values[i] - _mean) * (_values[i] - _mean);
+
+		return _sum;
+	}
+
+	INDICATORS_TARGET_AVX2 void weightedSumsAvx2(const double* _prices, const double* _volumes, size_t _count, double& _sumPV, double& _sumV)
+	{
+		__m256d _pv0 = _mm256_setzero_pd();
+		__m256d _pv1 = _mm256_setzero_pd();
+		__m256d _v0 = _mm256_setzero_pd();
+		__m256d _v1 = _mm256_setzero_pd();
+		size_t i = 0;
+
+		for (; i + 8 <= _count; i += 8)
+		{
+			__m256d _volume0 = _mm256_loadu_pd(_volumes + i);
+			__m256d _volume1 = _mm256_loadu_pd(_volumes + i + 4);
+			_pv0 = _mm256_add_pd(_pv0, _mm256_mul_pd(_mm256_loadu_pd(_prices + i), _volume0));
+			_pv1 = _mm256_add_pd(_pv1, _mm256_mul_pd(_mm256_loadu_pd(_prices + i + 4), _volume1));
+			_v0 = _mm256_add_pd(_v0, _volume0);
+			_v1 = _mm256_add_pd(_v1, _volume1);
+		}
+
+		_sumPV = horizontalSum(_mm256_add_pd(_pv0, _pv1));
+		_sumV = horizontalSum(_mm256_add_pd(_v0, _v1));
+
+		for (; i < _count; ++i)
+		{
+			_sumPV += _prices[i] * _volumes[i];
+			_sumV += _volumes[i];
+		}
+	}
+
+	INDICATORS_TARGET_AVX2 void typicalValuesAvx2(const double* _high, const double* _low, const double* _close, const double* _volume, size_t _count, double* _result)
+	{
+		const __m256d _third = _mm256_set1_pd(1.0 / 3);
+		size_t i = 0;
+
+		for (; i + 4 <= _count; i += 4)
+		{
+			__m256d _typical = _mm256_add_pd(_mm256_add_pd(_mm256_loadu_pd(_high + i), _mm256_loadu_pd(_low + i)), _mm256_loadu_pd(_close + i));
+			_mm256_storeu_pd(_result + i, _mm256_mul_pd(_mm256_mul_pd(_typical, _third), _mm256_loadu_pd(_volume + i)));
+		}
+
+		for (; i < _count; ++i)
+			_result[i] = (_high[i] + _low[i] + _close[i]) * (1.0 / 3) * _volume[i];
+	}
+
+	const s_kernels avx2_kernels =
+	{
+		windowSumAvx2, combineMinimumAvx2, combineMaximumAvx2, returnsAvx2, sumAvx2,
+		squaredDeviationsAvx2, weightedSumsAvx2, typicalValuesAvx2, "avx2"
+	};
+
+	void cpuid(uint32_t _leaf, uint32_t _subleaf, uint32_t& _a, uint32_t& _b, uint32_t& _c, uint32_t& _d)
+	{
+#if defined(_MSC_VER)
+		int _registers[4];
+		__cpuidex(_registers, _leaf, _subleaf);
+		_a = _registers[0], _b = _registers[1], _c = _registers[2], _d = _registers[3];
+#else
+		__asm__("cpuid" : "=a"(_a), "=b"(_b), "=c"(_c), "=d"(_d) : "0"(_leaf), "2"(_subleaf));
+#endif
+	}
+
+	/**
+		Returns register state components the OS saves on context switch (XCR0)
+	*/
+	uint64_t xgetbv()
+	{
+#if defined(_MSC_VER)
+		return _xgetbv(0);
+#else
+		uint32_t _a, _d;
+		__asm__("xgetbv" : "=a"(_a), "=d"(_d) : "c"(0));
+		return (static_cast<uint64_t>(_d) << 32) | _a;
+#endif
+	}
+
+	bool supportsAvx2()
+	{
+		uint32_t _a, _b, _c, _d;
+
+		cpuid(0, 0, _a, _b, _c, _d);
+		if (_a < 7)
+			return false;
+
+		// the OS must save AVX registers too
+		cpuid(1, 0, _a, _b, _c, _d);
+		if (!((_c >> 27) & 1) || !((_c >> 28) & 1) || (xgetbv() & 0x6) != 0x6)
+			return false;
+
+		cpuid(7, 0, _a, _b, _c, _d);
+		return (_b >> 5) & 1;
+	}
+#endif
+
+	/**
+		Returns kernels for this CPU, picked on the first call
+	*/
+	const s_kernels& kernels()
+	{
+#ifdef INDICATORS_X86_DISPATCH
+		static const s_kernels& _kernels = supportsAvx2() ? avx2_kernels : standard_kernels;
+		return _kernels;
+#else
+		return standard_kernels;
+#endif
+	}
+
+	/**
+		Fills results that have no full window with NaN
+
+		@return false if there's no full window at all
+	*/
+	bool prepare(size_t _count, size_t _period, double* _result)
+	{
+		size_t _undefined = _period == 0 ? _count : std::min(_count, _period - 1);
+
+		for (size_t i = 0; i < _undefined; ++i)
+			_result[i] = not_a_number;
+
+		return _period != 0 && _period <= _count;
+	}
+
+	/**
+		Rolling extreme, _better returns the preferred one of two values
+	*/
+	template <typename Better>
+	void rollingExtreme(const double* _values, size_t _count, size_t _period, double* _result, Better _better,
+		void (*_combine)(const double*, size_t, size_t, double*))
+	{
+		if (!prepare(_count, _period, _result))
+			return;
+
+		// prefix extremes of blocks go straight to the result, suffix ones aside
+		std::vector<double> _suffix(_count);
+
+		for (size_t _block = 0; _block < _count; _block += _period)
+		{
+			size_t _end = std::min(_count, _block + _period);
+
+			double _extreme = _values[_block];
+			_result[_block] = _extreme;
+
+			for (size_t i = _block + 1; i < _end; ++i)
+			{
+				_extreme = _better(_extreme, _values[i]);
+				_result[i] = _extreme;
+			}
+
+			_extreme = _values[_end - 1];
+			_suffix[_end - 1] = _extreme;
+
+			for (size_t i = _end - 1; i-- > _block;)
+			{
+				_extreme = _better(_extreme, _values[i]);
+				_suffix[i] = _extreme;
+			}
+		}
+
+		_combine(_suffix.data(), _count, _period, _result);
+
+		// prefixes of the first windows are not complete ones
+		prepare(_count, _period, _result);
+	}
+
+	long periodStart(long _time, long _seconds)
+	{
+		long _rest = _time % _seconds;
+		return _time - (_rest < 0 ? _rest + _seconds : _rest);
+	}
+}
+
+void movingAverage(const double* _values, size_t _count, size_t _period, double* _result)
+{
+	if (prepare(_count, _period, _result))
+		kernels().windowSum(_values, _count, _period, 1.0 / _period, _result);
+}
+
+void exponentialAverage(const double* _values, size_t _count, size_t _period, double* _result)
+{
+	if (!prepare(_count, _period, _result))
+		return;
+
+	// every value depends on the previous one, there's nothing to vectorise
+	double _smoothing = 2.0 / (_period + 1);
+	double _average = kernels().sum(_values, _period) / _period;
+
+	_result[_period - 1] = _average;
+
+	for (size_t i = _period; i < _count; ++i)
+	{
+		_average += _smoothing * (_values[i] - _average);
+		_result[i] = _average;
+	}
+}
+
+void rollingMinimum(const double* _values, size_t _count, size_t _period, double* _result)
+{
+	rollingExtreme(_values, _count, _period, _result, [](double _a, double _b) { return std::min(_a, _b); }, kernels().combineMinimum);
+}
+
+void rollingMaximum(const double* _values, size_t _count, size_t _period, double* _result)
+{
+	rollingExtreme(_values, _count, _period, _result, [](double _a, double _b) { return std::max(_a, _b); }, kernels().combineMaximum);
+}
+
+void rollingDeviation(const double* _values, size_t _count, size_t _period, double* _result)
+{
+	if (!prepare(_count, _period, _result))
+		return;
+
+	const s_kernels& _kernels = kernels();
+	// the mean is kept as a sum of two doubles, small steps added to a large mean would be rounded away
+	double _mean = 0;
+	double _meanError = 0;
+	double _squares = 0;
+
+	// squares are kept around the mean of the current window, sums of plain squares lose precision far from 0
+	for (size_t i = _period - 1; i < _count; ++i)
+	{
+		size_t _first = i + 1 - _period;
+
+		if (_first % resync_interval == 0)
+		{
+			// computed again from the window, so rounding errors of updates don't pile up
+			_mean = _kernels.sum(_values + _first, _period) / _period;
+			_meanError = 0;
+
+			for (size_t j = _first; j <= i; ++j)
+				_meanError += _values[j] - _mean;
+
+			_meanError /= _period;
+			_squares = _kernels.squaredDeviations(_values + _first, _period, _mean) - _meanError * _meanError * _period;
+		}
+		else
+		{
+			// Welford's update for the value leaving the window and the one entering it
+			double _leaving = _values[_first - 1];
+			double _entering = _values[i];
+			double _before = (_leaving - _mean) - _meanError;
+			double _step = (_entering - _leaving) / _period;
+			double _moved = _mean + _step;
+			double _added = _moved - _mean;
+			_meanError += (_mean - (_moved - _added)) + (_step - _added);
+			_mean = _moved;
+			_squares += (_entering - _leaving) * ((_entering - _mean) - _meanError + _before);
+		}
+
+		_result[i] = std::sqrt(std::max(0.0, _squares / _period));
+	}
+}
+
+void returns(const double* _values, size_t _count, double* _result)
+{
+	if (!_count)
+		return;
+
+	_result[0] = not_a_number;
+	kernels().returns(_values, _count, _result);
+}
+
+double mean(const double* _values, size_t _count)
+{
+	if (!_count)
+		return not_a_number;
+
+	return kernels().sum(_values, _count) / _count;
+}
+
+double standardDeviation(const double* _values, size_t _count)
+{
+	if (!_count)
+		return not_a_number;
+
+	double _mean = mean(_values, _count);
+	return std::sqrt(kernels().squaredDeviations(_values, _count, _mean) / _count);
+}
+
+double vwap(const double* _prices, const double* _volumes, size_t _count)
+{
+	double _sumPV;
+	double _sumV;
+
+	kernels().weightedSums(_prices, _volumes, _count, _sumPV, _sumV);
+
+	return _sumV != 0 ? _sumPV / _sumV : not_a_number;
+}
+
+double vwap(const CandleColumns& _candles)
+{
+	size_t _count = _candles.size();
+	std::vector<double> _values(_count);
+
+	kernels().typicalValues(_candles.high().data(), _candles.low().data(), _candles.close().data(), _candles.vol().data(), _count, _values.data());
+
+	double _sumV = kernels().sum(_candles.vol().data(), _count);
+	return _sumV != 0 ? kernels().sum(_values.data(), _count) / _sumV : not_a_number;
+}
+
+double vwap(const s_trades& _trades)
+{
+	double _sumPV = 0;
+	double _sumV = 0;
+
+	for (const s_trade& _trade : _trades.trades)
+	{
+		_sumPV += _trade.price * _trade.amount;
+		_sumV += _trade.amount;
+	}
+
+	return _sumV != 0 ? _sumPV / _sumV : not_a_number;
+}
+
+void rollingVwap(const CandleColumns& _candles, size_t _period, double* _result)
+{
+	size_t _count = _candles.size();
+
+	if (!prepare(_count, _period, _result))
+		return;
+
+	const s_kernels& _kernels = kernels();
+	std::vector<double> _values(_count);
+	std::vector<double> _volumes(_count);
+
+	_kernels.typicalValues(_candles.high().data(), _candles.low().data(), _candles.close().data(), _candles.vol().data(), _count, _values.data());
+	_kernels.windowSum(_values.data(), _count, _period, 1, _result);
+	_kernels.windowSum(_candles.vol().data(), _count, _period, 1, _volumes.data());
+
+	for (size_t i = _period - 1; i < _count; ++i)
+		_result[i] = _volumes[i] != 0 ? _result[i] / _volumes[i] : not_a_number;
+}
+
+void resample(const s_trades& _trades, long _seconds, CandleColumns& _candles)
+{
+	if (_seconds <= 0 || _trades.trades.empty())
+		return;
+
+	// trades are merged in order of their ids, whichever order they came in
+	std::vector<const s_trade*> _ordered;
+	_ordered.reserve(_trades.trades.size());
+
+	for (const s_trade& _trade : _trades.trades)
+		_ordered.push_back(&_trade);
+
+	auto _earlier = [](const s_trade* _a, const s_trade* _b) { return _a->tid < _b->tid; };
+
+	if (!std::is_sorted(_ordered.begin(), _ordered.end(), _earlier))
+		std::sort(_ordered.begin(), _ordered.end(), _earlier);
+
+	s_graphPoint _point = { periodStart(_ordered[0]->date, _seconds), _ordered[0]->price, _ordered[0]->price, _ordered[0]->price, _ordered[0]->price, 0 };
+
+	for (const s_trade* _trade : _ordered)
+	{
+		long _start = periodStart(_trade->date, _seconds);
+
+		if (_start != _point.time)
+		{
+			_candles.push_back(_point);
+			_point = { _start, _trade->price, _trade->price, _trade->price, _trade->price, 0 };
+		}
+
+		_point.high = std::max(_point.high, _trade->price);
+		_point.low = std::min(_point.low, _trade->price);
+		_point.close = _trade->price;
+		_point.vol += _trade->amount;
+	}
+
+	_candles.push_back(_point);
+}
+
+void resample(const CandleColumns& _candles, long _seconds, CandleColumns& _result)
+{
+	if (_seconds <= 0 || _candles.empty())
+		return;
+
+	s_graphPoint _point = _candles[0];
+	_point.time = periodStart(_point.time, _seconds);
+
+	for (size_t i = 1; i < _candles.size(); ++i)
+	{
+		CandleColumns::s_constPointRef _candle = _candles[i];
+		long _start = periodStart(_candle.time, _seconds);
+
+		if (_start != _point.time)
+		{
+			_result.push_back(_point);
+			_point = _candle;
+			_point.time = _start;
+			continue;
+		}
+
+		_point.high = std::max(_point.high, _candle.high);
+		_point.low = std::min(_point.low, _candle.low);
+		_point.close = _candle.close;
+		_point.vol += _candle.vol;
+	}
+
+	_result.push_back(_point);
+}
+
+std::string indicatorsImplementation()
+{
+	return kernels().name;
+}
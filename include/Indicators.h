@@ -0,0 +1,109 @@
+/*
+	Copyright (c) 2019 Maciej Goncerz <https://github.com/Paurin1>.
+	Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+	Indicators.h file declares technical indicators computed over columns
+	of CandleColumns (or any other array of doubles) and over trades.
+
+	Rolling indicators write one result per input value: _result[i] is
+	computed from the window of _period values ending at _values[i], the
+	first _period - 1 results are NaN. Output arrays must be as long as the
+	input and may not overlap with it.
+
+	Loops over columns have AVX2 variants picked at startup on CPUs that
+	support it, others use the standard ones. Both give the same results
+	up to rounding of sums, which are added in a different order.
+*/
+
+#ifndef INDICATORS_H
+#define INDICATORS_H
+
+#include <cstddef>	// size_t
+#include <string>	// string
+
+// Columns of graph's points
+#include "CandleColumns.h"
+
+// Defines s_trades
+#include "PublicApiDataStructures.h"
+
+/**
+	Simple moving average
+*/
+void movingAverage(const double* _values, size_t _count, size_t _period, double* _result);
+
+/**
+	Exponential moving average with smoothing 2 / (_period + 1), started with simple average of the first window
+*/
+void exponentialAverage(const double* _values, size_t _count, size_t _period, double* _result);
+
+/**
+	Lowest and highest value of every window, O(1) per value regardless of the period
+*/
+void rollingMinimum(const double* _values, size_t _count, size_t _period, double* _result);
+void rollingMaximum(const double* _values, size_t _count, size_t _period, double* _result);
+
+/**
+	Population standard deviation of every window, Welford's update around
+	the window's mean rather than sums of squares. On price series it stays
+	within about 1e-13 relative of a two-pass computation over each window,
+	only windows whose spread is tiny compared to their values lose more
+*/
+void rollingDeviation(const double* _values, size_t _count, size_t _period, double* _result);
+
+/**
+	Relative change to the previous value, _result[0] is NaN
+*/
+void returns(const double* _values, size_t _count, double* _result);
+
+/**
+	Mean and population standard deviation of the whole array, NaN if it's empty
+*/
+double mean(const double* _values, size_t _count);
+double standardDeviation(const double* _values, size_t _count);
+
+/**
+	Volume weighted average price
+
+	@return NaN if there's no volume
+*/
+double vwap(const double* _prices, const double* _volumes, size_t _count);
+
+/**
+	Volume weighted average of typical prices (high + low + close) / 3 of every point
+*/
+double vwap(const CandleColumns& _candles);
+
+/**
+	Volume weighted average price of trades
+*/
+double vwap(const s_trades& _trades);
+
+/**
+	Volume weighted average of typical prices of every window of points
+
+	@param _result array of _candles.size() values
+*/
+void rollingVwap(const CandleColumns& _candles, size_t _period, double* _result);
+
+/**
+	Builds points of given length in seconds out of trades, periods without trades are skipped
+
+	@param _candles points are appended to it, time is the start of point's period
+*/
+void resample(const s_trades& _trades, long _seconds, CandleColumns& _candles);
+
+/**
+	Merges points into longer ones, e.g. 1h points out of 5m ones
+
+	@param _candles points sorted by time
+	@param _result points are appended to it
+*/
+void resample(const CandleColumns& _candles, long _seconds, CandleColumns& _result);
+
+/**
+	Returns name of the loops in use, "avx2" or "standard"
+*/
+std::string indicatorsImplementation();
+
+#endif
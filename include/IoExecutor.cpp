@@ -0,0 +1,79 @@
+/*
+	Copyright (c) 2019 Maciej Goncerz <https://github.com/Paurin1>.
+	Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+	More detailed descriptions are in IoExecutor.h file.
+*/
+
+#include "IoExecutor.h"
+
+IoExecutor::IoExecutor(size_t _threads) : m_stopping(false)
+{
+	if (_threads == 0)
+		_threads = 1;
+
+	for (size_t i = 0; i < _threads; ++i)
+		m_threads.emplace_back(&IoExecutor::f_work, this);
+}
+
+IoExecutor::~IoExecutor()
+{
+	{
+		std::lock_guard<std::mutex> _lock(m_mutex);
+		m_stopping = true;
+	}
+
+	m_condition.notify_all();
+
+	for (auto& _thread : m_threads)
+		_thread.join();
+}
+
+std::shared_ptr<IoExecutor> IoExecutor::shared()
+{
+	static std::shared_ptr<IoExecutor> _shared = std::make_shared<IoExecutor>();
+	return _shared;
+}
+
+void IoExecutor::post(std::function<void()> _task)
+{
+	{
+		std::lock_guard<std::mutex> _lock(m_mutex);
+		m_tasks.push_back(std::move(_task));
+	}
+
+	m_condition.notify_one();
+}
+
+size_t IoExecutor::threads() const
+{
+	return m_threads.size();
+}
+
+void IoExecutor::f_work()
+{
+	while (true)
+	{
+		std::function<void()> _task;
+
+		{
+			std::unique_lock<std::mutex> _lock(m_mutex);
+			m_condition.wait(_lock, [this]() { return m_stopping || !m_tasks.empty(); });
+
+			// queued tasks are finished even when the executor is being destroyed
+			if (m_tasks.empty())
+				return;
+
+			_task = std::move(m_tasks.front());
+			m_tasks.pop_front();
+		}
+
+		// an exception thrown by a task must not stop the worker thread
+		try
+		{
+			_task();
+		}
+		catch (...)
+		{ }
+	}
+}
@@ -0,0 +1,101 @@
+/*
+	Copyright (c) 2019 Maciej Goncerz <https://github.com/Paurin1>.
+	Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+	IoExecutor class is a fixed-size pool of threads that run blocking
+	requests in the background. It's used by asynchronous methods of
+	BitmarketPublic and BitmarketPrivate so that the calling thread can
+	have many requests in flight at once.
+*/
+
+#ifndef IOEXECUTOR_H
+#define IOEXECUTOR_H
+
+#include <vector>				// vector
+#include <deque>				// deque
+#include <thread>				// thread
+#include <mutex>				// mutex, unique_lock
+#include <condition_variable>	// condition_variable
+#include <functional>			// function
+#include <future>				// future, packaged_task
+#include <memory>				// shared_ptr
+#include <type_traits>			// invoke_result_t, result_of
+
+class IoExecutor
+{
+public:
+	// std::result_of is removed in C++20, older standards don't have std::invoke_result
+#if (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L) || __cplusplus >= 201703L
+	template <typename T_task>
+	using task_result = std::invoke_result_t<T_task>;
+#else
+	template <typename T_task>
+	using task_result = typename std::result_of<T_task()>::type;
+#endif
+
+	/**
+		Starts worker threads
+
+		@param _threads number of requests that may be executed at the same time
+	*/
+	IoExecutor(size_t _threads = 8);
+
+	/**
+		Finishes every queued task and joins worker threads
+	*/
+	~IoExecutor();
+
+	IoExecutor(const IoExecutor&) = delete;
+	IoExecutor& operator=(const IoExecutor&) = delete;
+
+	/**
+		Returns the executor shared by default by every BitmarketPublic and BitmarketPrivate object
+	*/
+	static std::shared_ptr<IoExecutor> shared();
+
+	/**
+		Queues a task to be run on one of worker threads
+
+		@param _task function to be called
+	*/
+	void post(std::function<void()> _task);
+
+	/**
+		Queues a task and returns future of its result
+
+		@param _task function to be called
+		@return future that becomes ready when the task has finished
+	*/
+	template <typename T_task>
+	std::future<task_result<T_task>> submit(T_task _task)
+	{
+		typedef task_result<T_task> T_result;
+
+		// packaged_task is move-only so it's wrapped to fit in std::function
+		auto _packaged = std::make_shared<std::packaged_task<T_result()>>(_task);
+		std::future<T_result> _future = _packaged->get_future();
+
+		post([_packaged]() { (*_packaged)(); });
+
+		return _future;
+	}
+
+	/**
+		Returns number of worker threads
+	*/
+	size_t threads() const;
+
+private:
+	/**
+		Main loop of every worker thread
+	*/
+	void f_work();
+
+	std::vector<std::thread> m_threads;
+	std::deque<std::function<void()>> m_tasks;
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+	bool m_stopping;
+};
+
+#endif
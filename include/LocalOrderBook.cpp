@@ -0,0 +1,325 @@
+/*
+	Copyright (c) 2019 Maciej Goncerz <https://github.com/Paurin1>.
+	Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+	More detailed descriptions are in LocalOrderBook.h file.
+*/
+
+#include "LocalOrderBook.h"
+
+#include <algorithm>	// stable_sort, is_sorted, upper_bound, min, max
+
+LocalOrderBook::LocalOrderBook(std::string _market) : m_market(_market)
+{ }
+
+size_t LocalOrderBook::apply(const s_orderBook& _snapshot)
+{
+	size_t _changed = f_merge(e_bids, f_convert(_snapshot.bids));
+	return _changed + f_merge(e_asks, f_convert(_snapshot.asks));
+}
+
+size_t LocalOrderBook::apply(const s_fixedOrderBook& _snapshot)
+{
+	return f_merge(e_bids, _snapshot.bids) + f_merge(e_asks, _snapshot.asks);
+}
+
+size_t LocalOrderBook::applyTrade(const s_trade& _trade)
+{
+	return applyTrade(s_fixedTrade{ Decimal::fromDouble(_trade.amount), Decimal::fromDouble(_trade.price), _trade.date, _trade.tid, _trade.type });
+}
+
+size_t LocalOrderBook::applyTrade(const s_fixedTrade& _trade)
+{
+	// a buy has been matched with asks, a sell with bids
+	e_side _side = _trade.type == "buy" ? e_asks : e_bids;
+	s_levels& _levels = m_sides[_side];
+
+	size_t _changed = 0;
+	size_t _removed = 0;
+	Decimal _left = _trade.amount;
+
+	// levels better than the trade's price have been taken whole, the one at the price partially
+	while (_removed < _levels.prices.size() && !f_better(_side, _trade.price, _levels.prices[_removed]))
+	{
+		Decimal _price = _levels.prices[_removed];
+		Decimal _amount = _levels.amounts[_removed];
+
+		if (_price == _trade.price && _amount > _left)
+		{
+			// better levels may have taken the whole amount, then this one is untouched
+			if (_left > Decimal())
+			{
+				_levels.amounts[_removed] = _amount - _left;
+				f_emit(_side, e_changed, _price, _amount - _left, _amount);
+				++_changed;
+			}
+
+			break;
+		}
+
+		_left = std::max(Decimal(), _left - _amount);
+		f_emit(_side, e_removed, _price, Decimal(), _amount);
+		++_changed;
+		++_removed;
+	}
+
+	if (_changed)
+	{
+		_levels.prices.erase(_levels.prices.begin(), _levels.prices.begin() + _removed);
+		_levels.amounts.erase(_levels.amounts.begin(), _levels.amounts.begin() + _removed);
+		_levels.cumulative.resize(_levels.prices.size());
+		f_accumulate(_levels);
+	}
+
+	return _changed;
+}
+
+void LocalOrderBook::onLevel(level_callback _callback)
+{
+	m_callback = _callback;
+}
+
+void LocalOrderBook::clear()
+{
+	for (s_levels& _levels : m_sides)
+	{
+		_levels.prices.clear();
+		_levels.amounts.clear();
+		_levels.cumulative.clear();
+	}
+}
+
+const std::string& LocalOrderBook::market() const
+{
+	return m_market;
+}
+
+size_t LocalOrderBook::depth(e_side _side) const
+{
+	return m_sides[_side].prices.size();
+}
+
+bool LocalOrderBook::level(e_side _side, size_t _index, s_order& _order) const
+{
+	const s_levels& _levels = m_sides[_side];
+
+	if (_index >= _levels.prices.size())
+		return false;
+
+	_order.exchangeRate = _levels.prices[_index].toDouble();
+	_order.amount = _levels.amounts[_index].toDouble();
+
+	return true;
+}
+
+bool LocalOrderBook::level(e_side _side, size_t _index, s_fixedOrder& _order) const
+{
+	const s_levels& _levels = m_sides[_side];
+
+	if (_index >= _levels.prices.size())
+		return false;
+
+	_order.exchangeRate = _levels.prices[_index];
+	_order.amount = _levels.amounts[_index];
+
+	return true;
+}
+
+bool LocalOrderBook::best(e_side _side, s_order& _order) const
+{
+	return level(_side, 0, _order);
+}
+
+bool LocalOrderBook::best(e_side _side, s_fixedOrder& _order) const
+{
+	return level(_side, 0, _order);
+}
+
+Decimal LocalOrderBook::spread() const
+{
+	if (m_sides[e_bids].prices.empty() || m_sides[e_asks].prices.empty())
+		return Decimal();
+
+	return m_sides[e_asks].prices.front() - m_sides[e_bids].prices.front();
+}
+
+Decimal LocalOrderBook::volume(e_side _side, size_t _levels) const
+{
+	const std::vector<Decimal>& _cumulative = m_sides[_side].cumulative;
+
+	if (_levels == 0 || _cumulative.empty())
+		return Decimal();
+
+	return _cumulative[std::min(_levels, _cumulative.size()) - 1];
+}
+
+Decimal LocalOrderBook::volumeTo(e_side _side, Decimal _price) const
+{
+	const s_levels& _levels = m_sides[_side];
+
+	// first level worse than given price
+	auto _end = std::upper_bound(_levels.prices.begin(), _levels.prices.end(), _price,
+		[_side](Decimal _a, Decimal _b) { return f_better(_side, _a, _b); });
+
+	return volume(_side, _end - _levels.prices.begin());
+}
+
+const std::vector<Decimal>& LocalOrderBook::prices(e_side _side) const
+{
+	return m_sides[_side].prices;
+}
+
+const std::vector<Decimal>& LocalOrderBook::amounts(e_side _side) const
+{
+	return m_sides[_side].amounts;
+}
+
+std::shared_ptr<s_orderBook> LocalOrderBook::snapshot() const
+{
+	auto _book = std::make_shared<s_orderBook>();
+
+	for (e_side _side : { e_bids, e_asks })
+	{
+		const s_levels& _levels = m_sides[_side];
+		std::vector<s_order>& _orders = _side == e_bids ? _book->bids : _book->asks;
+
+		_orders.reserve(_levels.prices.size());
+
+		for (size_t i = 0; i < _levels.prices.size(); ++i)
+			_orders.push_back({ _levels.prices[i].toDouble(), _levels.amounts[i].toDouble() });
+	}
+
+	return _book;
+}
+
+std::shared_ptr<s_fixedOrderBook> LocalOrderBook::fixedSnapshot() const
+{
+	auto _book = std::make_shared<s_fixedOrderBook>();
+
+	for (e_side _side : { e_bids, e_asks })
+	{
+		const s_levels& _levels = m_sides[_side];
+		std::vector<s_fixedOrder>& _orders = _side == e_bids ? _book->bids : _book->asks;
+
+		_orders.reserve(_levels.prices.size());
+
+		for (size_t i = 0; i < _levels.prices.size(); ++i)
+			_orders.push_back({ _levels.prices[i], _levels.amounts[i] });
+	}
+
+	return _book;
+}
+
+bool LocalOrderBook::f_better(e_side _side, Decimal _a, Decimal _b)
+{
+	return _side == e_bids ? _a > _b : _a < _b;
+}
+
+const std::vector<s_fixedOrder>& LocalOrderBook::f_convert(const std::vector<s_order>& _orders)
+{
+	m_converted.clear();
+
+	for (const s_order& _order : _orders)
+		m_converted.push_back({ Decimal::fromDouble(_order.exchangeRate), Decimal::fromDouble(_order.amount) });
+
+	return m_converted;
+}
+
+size_t LocalOrderBook::f_merge(e_side _side, const std::vector<s_fixedOrder>& _orders)
+{
+	auto _better = [_side](const s_fixedOrder& _a, const s_fixedOrder& _b) { return f_better(_side, _a.exchangeRate, _b.exchangeRate); };
+
+	// the API sends sides already sorted, anything else is sorted on a copy
+	const std::vector<s_fixedOrder>* _sorted = &_orders;
+
+	if (!std::is_sorted(_orders.begin(), _orders.end(), _better))
+	{
+		m_sorted.assign(_orders.begin(), _orders.end());
+		std::stable_sort(m_sorted.begin(), m_sorted.end(), _better);
+		_sorted = &m_sorted;
+	}
+
+	s_levels& _current = m_sides[_side];
+	s_levels& _next = m_scratch;
+
+	_next.prices.clear();
+	_next.amounts.clear();
+
+	size_t _changed = 0;
+	size_t i = 0;
+	size_t j = 0;
+
+	while (i < _current.prices.size() || j < _sorted->size())
+	{
+		// current level better than any new one has disappeared
+		if (j == _sorted->size() || (i < _current.prices.size() && f_better(_side, _current.prices[i], (*_sorted)[j].exchangeRate)))
+		{
+			f_emit(_side, e_removed, _current.prices[i], Decimal(), _current.amounts[i]);
+			++_changed;
+			++i;
+			continue;
+		}
+
+		// orders with equal prices form one level
+		Decimal _price = (*_sorted)[j].exchangeRate;
+		Decimal _amount;
+
+		while (j < _sorted->size() && (*_sorted)[j].exchangeRate == _price)
+			_amount += (*_sorted)[j++].amount;
+
+		bool _existed = i < _current.prices.size() && _current.prices[i] == _price;
+		Decimal _previous = _existed ? _current.amounts[i++] : Decimal();
+
+		if (_amount <= Decimal())
+		{
+			if (_existed)
+			{
+				f_emit(_side, e_removed, _price, Decimal(), _previous);
+				++_changed;
+			}
+
+			continue;
+		}
+
+		if (!_existed)
+		{
+			f_emit(_side, e_added, _price, _amount, Decimal());
+			++_changed;
+		}
+		else if (_previous != _amount)
+		{
+			f_emit(_side, e_changed, _price, _amount, _previous);
+			++_changed;
+		}
+
+		_next.prices.push_back(_price);
+		_next.amounts.push_back(_amount);
+	}
+
+	if (_changed)
+	{
+		std::swap(_current.prices, _next.prices);
+		std::swap(_current.amounts, _next.amounts);
+		_current.cumulative.resize(_current.prices.size());
+		f_accumulate(_current);
+	}
+
+	return _changed;
+}
+
+void LocalOrderBook::f_accumulate(s_levels& _levels)
+{
+	Decimal _sum;
+
+	for (size_t i = 0; i < _levels.amounts.size(); ++i)
+	{
+		_sum += _levels.amounts[i];
+		_levels.cumulative[i] = _sum;
+	}
+}
+
+void LocalOrderBook::f_emit(e_side _side, e_change _change, Decimal _price, Decimal _amount, Decimal _previousAmount)
+{
+	if (m_callback)
+		m_callback({ _side, _change, _price, _amount, _previousAmount });
+}
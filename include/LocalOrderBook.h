@@ -0,0 +1,186 @@
+/*
+	Copyright (c) 2019 Maciej Goncerz <https://github.com/Paurin1>.
+	Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+	LocalOrderBook class maintains order book of one market in memory.
+	Every side is kept as sorted arrays of prices, amounts and cumulative
+	amounts, best level first. Values are stored as Decimal, so levels are
+	matched exactly and sums don't drift; snapshots with doubles are
+	rounded to Decimal's unit on the way in. A new snapshot from BitmarketPublic is
+	merged with the current levels and only levels that differ produce
+	events, so consumers don't need to rescan the whole book.
+
+	Trades seen between snapshots can be applied too: a buy takes amount
+	from asks, a sell from bids. The next snapshot corrects whatever the
+	estimate got wrong.
+
+	The object is not synchronized, use it from one thread (i.e. in
+	MarketDataScheduler's callbacks).
+*/
+
+#ifndef LOCALORDERBOOK_H
+#define LOCALORDERBOOK_H
+
+#include <string>		// string
+#include <vector>		// vector
+#include <memory>		// shared_ptr
+#include <functional>	// function
+
+// Defines order book and trade structures, also their Decimal variants
+#include "PublicApiDataStructures.h"
+
+class LocalOrderBook
+{
+public:
+	enum e_side
+	{
+		e_bids,
+		e_asks
+	};
+
+	enum e_change
+	{
+		e_added,
+		e_changed,
+		e_removed
+	};
+
+	/**
+		Change of one price level
+	*/
+	struct s_levelEvent
+	{
+		e_side side;
+		e_change change;
+		Decimal price;
+		Decimal amount;			// 0 when the level has been removed
+		Decimal previousAmount;	// 0 when the level has been added
+	};
+
+	typedef std::function<void(const s_levelEvent&)> level_callback;
+
+	/**
+		@param _market name of the market, only for the user's information
+	*/
+	LocalOrderBook(std::string _market = "BTCPLN");
+
+	/**
+		Replaces the book with given snapshot, emitting events for levels that differ
+
+		@return number of changed levels
+	*/
+	size_t apply(const s_orderBook& _snapshot);
+	size_t apply(const s_fixedOrderBook& _snapshot);
+
+	/**
+		Takes amount of a trade from the side it has been executed against
+
+		@return number of changed levels
+	*/
+	size_t applyTrade(const s_trade& _trade);
+	size_t applyTrade(const s_fixedTrade& _trade);
+
+	/**
+		Sets function called for every changed level, empty function disables events
+	*/
+	void onLevel(level_callback _callback);
+
+	/**
+		Removes every level without emitting events
+	*/
+	void clear();
+
+	const std::string& market() const;
+
+	/**
+		Returns number of price levels on given side
+	*/
+	size_t depth(e_side _side) const;
+
+	/**
+		Returns price and amount of given level, 0 is the best one
+
+		@return false if there is no such level
+	*/
+	bool level(e_side _side, size_t _index, s_order& _order) const;
+	bool level(e_side _side, size_t _index, s_fixedOrder& _order) const;
+
+	/**
+		Returns the best level of given side
+
+		@return false if the side is empty
+	*/
+	bool best(e_side _side, s_order& _order) const;
+	bool best(e_side _side, s_fixedOrder& _order) const;
+
+	/**
+		Returns best ask minus best bid, 0 if any side is empty
+	*/
+	Decimal spread() const;
+
+	/**
+		Returns total amount of the best _levels levels, O(1)
+	*/
+	Decimal volume(e_side _side, size_t _levels) const;
+
+	/**
+		Returns total amount offered at given price or better, O(log n)
+	*/
+	Decimal volumeTo(e_side _side, Decimal _price) const;
+
+	/**
+		Returns contiguous arrays of a side, best level first, valid until the book changes
+	*/
+	const std::vector<Decimal>& prices(e_side _side) const;
+	const std::vector<Decimal>& amounts(e_side _side) const;
+
+	/**
+		Converts the book back into API's structure
+	*/
+	std::shared_ptr<s_orderBook> snapshot() const;
+	std::shared_ptr<s_fixedOrderBook> fixedSnapshot() const;
+
+private:
+	struct s_levels
+	{
+		std::vector<Decimal> prices;
+		std::vector<Decimal> amounts;
+
+		// cumulative[i] is the sum of amounts[0..i]
+		std::vector<Decimal> cumulative;
+	};
+
+	/**
+		Returns true if price _a is better than _b on given side
+	*/
+	static bool f_better(e_side _side, Decimal _a, Decimal _b);
+
+	/**
+		Merges sorted new levels with current ones, emits events and swaps them in
+	*/
+	size_t f_merge(e_side _side, const std::vector<s_fixedOrder>& _orders);
+
+	/**
+		Rounds orders with double values into m_converted
+	*/
+	const std::vector<s_fixedOrder>& f_convert(const std::vector<s_order>& _orders);
+
+	/**
+		Recalculates cumulative amounts of a side
+	*/
+	void f_accumulate(s_levels& _levels);
+
+	void f_emit(e_side _side, e_change _change, Decimal _price, Decimal _amount, Decimal _previousAmount);
+
+	std::string m_market;
+	s_levels m_sides[2];
+
+	// reused for merging and sorting, so steady updates don't allocate
+	s_levels m_scratch;
+	std::vector<s_fixedOrder> m_sorted;
+	std::vector<s_fixedOrder> m_converted;
+
+	level_callback m_callback;
+};
+
+#endif
@@ -0,0 +1,142 @@
+/*
+	Copyright (c) 2019 Maciej Goncerz <https://github.com/Paurin1>.
+	Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+	More detailed descriptions are in MappedFile.h file.
+*/
+
+#include "MappedFile.h"
+
+#include <utility>	// swap
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+MappedFile::MappedFile() :
+	m_data(nullptr), m_size(0),
+#ifdef _WIN32
+	m_file(INVALID_HANDLE_VALUE), m_mapping(nullptr)
+#else
+	m_file(-1)
+#endif
+{ }
+
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+MappedFile::MappedFile(MappedFile&& _other) noexcept : MappedFile()
+{
+	*this = std::move(_other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& _other) noexcept
+{
+	// the other object takes over whatever was mapped here and unmaps it
+	std::swap(m_data, _other.m_data);
+	std::swap(m_size, _other.m_size);
+	std::swap(m_file, _other.m_file);
+#ifdef _WIN32
+	std::swap(m_mapping, _other.m_mapping);
+#endif
+
+	return *this;
+}
+
+bool MappedFile::open(const std::string& _path, size_t _size, bool _create)
+{
+	close();
+
+	if (_size == 0)
+		return false;
+
+#ifdef _WIN32
+	m_file = CreateFileA(_path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, _create ? OPEN_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (m_file == INVALID_HANDLE_VALUE)
+		return false;
+
+	// the mapping extends a smaller file to its size
+	LARGE_INTEGER _mappingSize;
+	_mappingSize.QuadPart = static_cast<LONGLONG>(_size);
+
+	m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READWRITE, _mappingSize.HighPart, _mappingSize.LowPart, nullptr);
+	if (!m_mapping)
+	{
+		close();
+		return false;
+	}
+
+	m_data = static_cast<char*>(MapViewOfFile(m_mapping, FILE_MAP_ALL_ACCESS, 0, 0, _size));
+#else
+	m_file = ::open(_path.c_str(), O_RDWR | (_create ? O_CREAT : 0), 0644);
+	if (m_file < 0)
+		return false;
+
+	// extended file reads as zeros and takes no disk space until written
+	struct stat _status;
+	if (fstat(m_file, &_status) != 0 || (static_cast<size_t>(_status.st_size) < _size && ftruncate(m_file, static_cast<off_t>(_size)) != 0))
+	{
+		close();
+		return false;
+	}
+
+	void* _memory = mmap(nullptr, _size, PROT_READ | PROT_WRITE, MAP_SHARED, m_file, 0);
+	m_data = _memory != MAP_FAILED ? static_cast<char*>(_memory) : nullptr;
+#endif
+
+	if (!m_data)
+	{
+		close();
+		return false;
+	}
+
+	m_size = _size;
+	return true;
+}
+
+void MappedFile::close()
+{
+#ifdef _WIN32
+	if (m_data)
+		UnmapViewOfFile(m_data);
+
+	if (m_mapping)
+		CloseHandle(m_mapping);
+
+	if (m_file != INVALID_HANDLE_VALUE)
+		CloseHandle(m_file);
+
+	m_mapping = nullptr;
+	m_file = INVALID_HANDLE_VALUE;
+#else
+	if (m_data)
+		munmap(m_data, m_size);
+
+	if (m_file >= 0)
+		::close(m_file);
+
+	m_file = -1;
+#endif
+
+	m_data = nullptr;
+	m_size = 0;
+}
+
+bool MappedFile::flush()
+{
+	if (!m_data)
+		return false;
+
+#ifdef _WIN32
+	return FlushViewOfFile(m_data, m_size) && FlushFileBuffers(m_file);
+#else
+	return msync(m_data, m_size, MS_SYNC) == 0;
+#endif
+}
@@ -0,0 +1,73 @@
+/*
+	Copyright (c) 2019 Maciej Goncerz <https://github.com/Paurin1>.
+	Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+	MappedFile class maps a whole file into memory for reading and writing.
+	The file is created or extended to the requested size when it's opened,
+	so its size is fixed for as long as it's mapped. Changes are written
+	back by the system, flush() waits until they reach the disk.
+
+	Works on Windows as well as on Linux.
+*/
+
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>	// size_t
+#include <string>	// string
+
+class MappedFile
+{
+public:
+	MappedFile();
+
+	/**
+		Unmaps the file
+	*/
+	~MappedFile();
+
+	MappedFile(MappedFile&& _other) noexcept;
+	MappedFile& operator=(MappedFile&& _other) noexcept;
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	/**
+		Maps given file, an open one is unmapped first
+
+		@param _path path of the file
+		@param _size size of the mapping, a smaller file is extended with zeros
+		@param _create whether a file that doesn't exist is created
+		@return false if the file couldn't be opened or mapped
+	*/
+	bool open(const std::string& _path, size_t _size, bool _create);
+
+	/**
+		Unmaps the file, its memory is no longer valid
+	*/
+	void close();
+
+	/**
+		Writes changed memory to the disk and waits until it's done
+
+		@return false on error
+	*/
+	bool flush();
+
+	char* data() const		{ return m_data; }
+	size_t size() const		{ return m_size; }
+	bool isOpen() const		{ return m_data != nullptr; }
+
+private:
+	char* m_data;
+	size_t m_size;
+
+#ifdef _WIN32
+	void* m_file;
+	void* m_mapping;
+#else
+	int m_file;
+#endif
+};
+
+#endif
@@ -0,0 +1,242 @@
+/*
+	Copyright (c) 2019 Maciej Goncerz <https://github.com/Paurin1>.
+	Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+	More detailed descriptions are in MarketDataScheduler.h file.
+*/
+
+#include "MarketDataScheduler.h"
+
+#include <algorithm>	// min, sort
+
+MarketDataScheduler::MarketDataScheduler(BitmarketPublic& _api, EventLoop& _loop, std::shared_ptr<RateLimiter> _budget) :
+	m_api(_api), m_loop(_loop), m_budget(_budget ? _budget : std::make_shared<RateLimiter>(1.0, 5.0)),
+	m_nextId(1), m_wakePending(false), m_self(std::make_shared<MarketDataScheduler*>(this))
+{ }
+
+unsigned long MarketDataScheduler::subscribeTicker(std::string _market, std::chrono::milliseconds _interval, std::function<void(std::shared_ptr<const s_ticker>)> _callback)
+{
+	return f_subscribe(e_ticker, _market, _interval, [_callback](const std::shared_ptr<const void>& _data) { _callback(std::static_pointer_cast<const s_ticker>(_data)); });
+}
+
+unsigned long MarketDataScheduler::subscribeOrderbook(std::string _market, std::chrono::milliseconds _interval, std::function<void(std::shared_ptr<const s_orderBook>)> _callback)
+{
+	return f_subscribe(e_orderbook, _market, _interval, [_callback](const std::shared_ptr<const void>& _data) { _callback(std::static_pointer_cast<const s_orderBook>(_data)); });
+}
+
+unsigned long MarketDataScheduler::subscribeTrades(std::string _market, std::chrono::milliseconds _interval, std::function<void(std::shared_ptr<const s_trades>)> _callback)
+{
+	return f_subscribe(e_trades, _market, _interval, [_callback](const std::shared_ptr<const void>& _data) { _callback(std::static_pointer_cast<const s_trades>(_data)); });
+}
+
+void MarketDataScheduler::unsubscribe(unsigned long _id)
+{
+	for (auto _feed = m_feeds.begin(); _feed != m_feeds.end(); ++_feed)
+	{
+		std::vector<s_subscriber>& _subscribers = _feed->second.subscribers;
+
+		for (auto _subscriber = _subscribers.begin(); _subscriber != _subscribers.end(); ++_subscriber)
+		{
+			if (_subscriber->id != _id)
+				continue;
+
+			_subscribers.erase(_subscriber);
+
+			// a feed without subscribers is dropped, a response still in flight finds nothing
+			if (_subscribers.empty())
+			{
+				m_feeds.erase(_feed);
+				return;
+			}
+
+			// the feed slows down to the fastest of remaining subscribers
+			_feed->second.interval = _subscribers.front().interval;
+			for (const s_subscriber& _other : _subscribers)
+				_feed->second.interval = std::min(_feed->second.interval, _other.interval);
+
+			return;
+		}
+	}
+}
+
+size_t MarketDataScheduler::subscriptions() const
+{
+	size_t _count = 0;
+
+	for (const auto& _feed : m_feeds)
+		_count += _feed.second.subscribers.size();
+
+	return _count;
+}
+
+std::shared_ptr<RateLimiter> MarketDataScheduler::budget() const
+{
+	return m_budget;
+}
+
+unsigned long MarketDataScheduler::f_subscribe(e_endpoint _endpoint, const std::string& _market, std::chrono::milliseconds _interval, std::function<void(const std::shared_ptr<const void>&)> _callback)
+{
+	std::string _key = std::to_string(_endpoint) + "/" + _market;
+	unsigned long _id = m_nextId++;
+
+	auto _found = m_feeds.find(_key);
+	if (_found == m_feeds.end())
+	{
+		// a new feed is due at once, the budget spreads first requests of many feeds in time
+		s_feed _feed = { _endpoint, _market, {}, _interval, std::chrono::steady_clock::now(), false, -1 };
+		_found = m_feeds.emplace(_key, std::move(_feed)).first;
+	}
+
+	_found->second.subscribers.push_back({ _id, _interval, std::move(_callback) });
+	_found->second.interval = std::min(_found->second.interval, _interval);
+
+	// dispatching is posted so that subscriptions made before the loop runs are not sent one by one
+	std::weak_ptr<MarketDataScheduler*> _self = m_self;
+	m_loop.post([_self]()
+	{
+		if (auto _scheduler = _self.lock())
+			(*_scheduler)->f_dispatch();
+	});
+
+	return _id;
+}
+
+void MarketDataScheduler::f_dispatch()
+{
+	std::chrono::steady_clock::time_point _now = std::chrono::steady_clock::now();
+
+	// feeds that are due, the most overdue first
+	std::vector<std::pair<const std::string, s_feed>*> _due;
+	std::chrono::steady_clock::time_point _next = std::chrono::steady_clock::time_point::max();
+
+	for (auto& _feed : m_feeds)
+	{
+		if (_feed.second.inFlight)
+			continue;
+
+		if (_feed.second.due <= _now)
+			_due.push_back(&_feed);
+		else
+			_next = std::min(_next, _feed.second.due);
+	}
+
+	std::sort(_due.begin(), _due.end(), [](const std::pair<const std::string, s_feed>* _a, const std::pair<const std::string, s_feed>* _b)
+	{
+		return _a->second.due < _b->second.due;
+	});
+
+	for (auto _feed : _due)
+	{
+		if (!m_budget->tryAcquire())
+		{
+			// the rest waits for the next token
+			_next = std::min(_next, _now + m_budget->waitTime());
+			break;
+		}
+
+		f_request(_feed->first, _feed->second);
+	}
+
+	if (_next != std::chrono::steady_clock::time_point::max())
+		f_wakeAt(_next);
+}
+
+void MarketDataScheduler::f_request(const std::string& _key, s_feed& _feed)
+{
+	_feed.inFlight = true;
+
+	std::chrono::steady_clock::time_point _sent = std::chrono::steady_clock::now();
+	std::weak_ptr<MarketDataScheduler*> _self = m_self;
+	EventLoop* _loop = &m_loop;
+
+	// called on executor's thread, the result is handed over to the loop
+	auto _deliver = [_self, _loop, _key, _sent](std::shared_ptr<const void> _data)
+	{
+		_loop->post([_self, _key, _sent, _data]()
+		{
+			if (auto _scheduler = _self.lock())
+				(*_scheduler)->f_response(_key, _sent, _data);
+		});
+	};
+
+	switch (_feed.endpoint)
+	{
+	case e_ticker:
+		m_api.tickerAsync([_deliver](std::shared_ptr<const s_ticker> _data) { _deliver(_data); }, _feed.market);
+		break;
+
+	case e_orderbook:
+		m_api.orderbookAsync([_deliver](std::shared_ptr<const s_orderBook> _data) { _deliver(_data); }, _feed.market);
+		break;
+
+	case e_trades:
+		m_api.tradesAsync([_deliver](std::shared_ptr<const s_trades> _data) { _deliver(_data); }, static_cast<int>(_feed.since), _feed.market);
+		break;
+	}
+}
+
+void MarketDataScheduler::f_response(const std::string& _key, std::chrono::steady_clock::time_point _sent, std::shared_ptr<const void> _data)
+{
+	auto _found = m_feeds.find(_key);
+
+	// everyone has unsubscribed in the meantime
+	if (_found == m_feeds.end())
+		return;
+
+	s_feed& _feed = _found->second;
+	_feed.inFlight = false;
+
+	// cadence is kept from the moment the request was sent, a failed one is repeated on the next interval
+	_feed.due = _sent + _feed.interval;
+
+	bool _deliver = static_cast<bool>(_data);
+
+	if (_data && _feed.endpoint == e_trades)
+	{
+		const std::vector<s_trade>& _trades = std::static_pointer_cast<const s_trades>(_data)->trades;
+
+		// next request asks only for trades that follow the newest one
+		for (const s_trade& _trade : _trades)
+			_feed.since = std::max(_feed.since, _trade.tid);
+
+		_deliver = !_trades.empty();
+	}
+
+	if (_deliver)
+	{
+		// callbacks may unsubscribe, so they're called on a copy
+		std::vector<s_subscriber> _subscribers = _feed.subscribers;
+
+		for (const s_subscriber& _subscriber : _subscribers)
+			_subscriber.callback(_data);
+	}
+
+	f_dispatch();
+}
+
+void MarketDataScheduler::f_wakeAt(std::chrono::steady_clock::time_point _time)
+{
+	// a wake-up already posted for an earlier time will dispatch again anyway
+	if (m_wakePending && m_wakeAt <= _time)
+		return;
+
+	m_wakeAt = _time;
+	m_wakePending = true;
+
+	std::weak_ptr<MarketDataScheduler*> _self = m_self;
+	std::chrono::steady_clock::duration _delay = _time - std::chrono::steady_clock::now();
+
+	// rounded up, so the handler doesn't run before the time and find nothing to do
+	m_loop.postAfter(std::chrono::duration_cast<std::chrono::milliseconds>(_delay) + std::chrono::milliseconds(1), [_self, _time]()
+	{
+		auto _scheduler = _self.lock();
+		if (!_scheduler)
+			return;
+
+		// a wake-up replaced by an earlier one has nothing to clear
+		if ((*_scheduler)->m_wakeAt == _time)
+			(*_scheduler)->m_wakePending = false;
+
+		(*_scheduler)->f_dispatch();
+	});
+}
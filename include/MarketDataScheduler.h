@@ -0,0 +1,151 @@
+/*
+	Copyright (c) 2019 Maciej Goncerz <https://github.com/Paurin1>.
+	Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+	MarketDataScheduler class polls public API on behalf of subscribers.
+	A subscription names a market, an endpoint and how often fresh data is
+	wanted. Subscriptions to the same market and endpoint share requests.
+	Every request takes a token from a RateLimiter, when the budget runs
+	out the most overdue feed goes first, so the data stays as fresh as
+	the limits allow.
+
+	Requests run on BitmarketPublic's executor, the scheduler itself and
+	every callback run on given EventLoop's thread. Methods must be called
+	from that thread too (or before the loop is run).
+*/
+
+#ifndef MARKETDATASCHEDULER_H
+#define MARKETDATASCHEDULER_H
+
+#include <string>		// string
+#include <vector>		// vector
+#include <map>			// map
+#include <memory>		// shared_ptr, weak_ptr
+#include <functional>	// function
+#include <chrono>		// steady_clock, milliseconds
+
+// Public API whose asynchronous methods are used to poll
+#include "BitmarketPublic.h"
+
+// Loop the scheduler runs on
+#include "EventLoop.h"
+
+// Token bucket limiting number of requests
+#include "RateLimiter.h"
+
+class MarketDataScheduler
+{
+public:
+	/**
+		@param _api object requests are sent through, must outlive the scheduler
+		@param _loop loop running the scheduler and callbacks
+		@param _budget limiter shared with other users of the API, by default one request per second with bursts of five
+	*/
+	MarketDataScheduler(BitmarketPublic& _api, EventLoop& _loop, std::shared_ptr<RateLimiter> _budget = nullptr);
+
+	MarketDataScheduler(const MarketDataScheduler&) = delete;
+	MarketDataScheduler& operator=(const MarketDataScheduler&) = delete;
+
+	/**
+		Delivers ticker of given market at least every _interval
+
+		@return id of the subscription used to cancel it
+	*/
+	unsigned long subscribeTicker(std::string _market, std::chrono::milliseconds _interval, std::function<void(std::shared_ptr<const s_ticker>)> _callback);
+
+	/**
+		Delivers order book of given market at least every _interval
+
+		@return id of the subscription used to cancel it
+	*/
+	unsigned long subscribeOrderbook(std::string _market, std::chrono::milliseconds _interval, std::function<void(std::shared_ptr<const s_orderBook>)> _callback);
+
+	/**
+		Delivers trades of given market. The first response contains trades from last hour,
+		next ones only trades that followed them, empty results are not delivered.
+
+		@return id of the subscription used to cancel it
+	*/
+	unsigned long subscribeTrades(std::string _market, std::chrono::milliseconds _interval, std::function<void(std::shared_ptr<const s_trades>)> _callback);
+
+	/**
+		Cancels a subscription, its callback is not called anymore
+	*/
+	void unsubscribe(unsigned long _id);
+
+	/**
+		Returns number of active subscriptions
+	*/
+	size_t subscriptions() const;
+
+	/**
+		Returns the limiter every request takes a token from
+	*/
+	std::shared_ptr<RateLimiter> budget() const;
+
+private:
+	enum e_endpoint
+	{
+		e_ticker,
+		e_orderbook,
+		e_trades
+	};
+
+	struct s_subscriber
+	{
+		unsigned long id;
+		std::chrono::milliseconds interval;
+		std::function<void(const std::shared_ptr<const void>&)> callback;
+	};
+
+	// requests for one market and endpoint, shared by its subscribers
+	struct s_feed
+	{
+		e_endpoint endpoint;
+		std::string market;
+		std::vector<s_subscriber> subscribers;
+		std::chrono::milliseconds interval;
+		std::chrono::steady_clock::time_point due;
+		bool inFlight;
+		long since;
+	};
+
+	unsigned long f_subscribe(e_endpoint _endpoint, const std::string& _market, std::chrono::milliseconds _interval, std::function<void(const std::shared_ptr<const void>&)> _callback);
+
+	/**
+		Sends requests of feeds that are due while the budget allows and sets the next wake-up
+	*/
+	void f_dispatch();
+
+	/**
+		Sends request of given feed, the response is handled on the loop's thread
+	*/
+	void f_request(const std::string& _key, s_feed& _feed);
+
+	/**
+		Delivers response to subscribers and schedules the next request
+	*/
+	void f_response(const std::string& _key, std::chrono::steady_clock::time_point _sent, std::shared_ptr<const void> _data);
+
+	/**
+		Makes sure f_dispatch() runs at given time
+	*/
+	void f_wakeAt(std::chrono::steady_clock::time_point _time);
+
+	BitmarketPublic& m_api;
+	EventLoop& m_loop;
+	std::shared_ptr<RateLimiter> m_budget;
+
+	// feeds by endpoint and market
+	std::map<std::string, s_feed> m_feeds;
+	unsigned long m_nextId;
+
+	// earliest wake-up already posted to the loop
+	std::chrono::steady_clock::time_point m_wakeAt;
+	bool m_wakePending;
+
+	// handlers posted to the loop hold a weak pointer and do nothing once the scheduler is gone
+	std::shared_ptr<MarketDataScheduler*> m_self;
+};
+
+#endif
@@ -0,0 +1,190 @@
+/*
+	Copyright (c) 2019 Maciej Goncerz <https://github.com/Paurin1>.
+	Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+	More detailed descriptions are in NumericParse.h file.
+*/
+
+#include "NumericParse.h"
+
+#include <cstdint>	// uint64_t
+#include <cstdlib>	// strtod
+#include <clocale>	// localeconv
+#include <limits>	// numeric_limits
+
+#if defined(__has_include)
+#if __has_include(<charconv>) && ((defined(_MSVC_LANG) && _MSVC_LANG >= 201703L) || __cplusplus >= 201703L)
+#include <charconv>	// from_chars
+#endif
+#endif
+
+namespace
+{
+	// every power of 10 up to 10^22 is exact in double
+	const double exact_powers_of_10[] =
+	{
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+
+	// integers up to 2^53 are exact in double
+	const uint64_t max_exact_mantissa = 1ULL << 53;
+
+	inline bool isDigit(char _character)
+	{
+		return static_cast<unsigned char>(_character - '0') < 10;
+	}
+
+	/**
+		Converts a validated number without its sign when the fast path can't
+	*/
+	bool slowParse(const char* _begin, const char* _end, double& _value)
+	{
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+		std::from_chars_result _result = std::from_chars(_begin, _end, _value);
+		return _result.ec == std::errc() && _result.ptr == _end;
+#else
+		// strtod needs a terminated string with the locale's decimal point
+		char _buffer[128];
+
+		if (_end - _begin >= static_cast<long>(sizeof(_buffer)))
+			return false;
+
+		char _point = *std::localeconv()->decimal_point;
+		char* _current = _buffer;
+
+		for (const char* i = _begin; i != _end; ++i)
+			*_current++ = *i == '.' ? _point : *i;
+
+		*_current = '\0';
+
+		char* _stop;
+		_value = std::strtod(_buffer, &_stop);
+
+		return _stop == _current;
+#endif
+	}
+}
+
+bool parseNumber(const char* _begin, const char* _end, double& _value)
+{
+	const char* _current = _begin;
+	bool _negative = false;
+
+	if (_current != _end && (*_current == '-' || *_current == '+'))
+		_negative = *_current++ == '-';
+
+	const char* _start = _current;
+	uint64_t _mantissa = 0;
+	int _digits = 0;
+	int _exponent = 0;
+
+	// leading zeros don't count as significant digits
+	for (; _current != _end && *_current == '0'; ++_current)
+		;
+
+	bool _anyDigit = _current != _start;
+
+	for (; _current != _end && isDigit(*_current); ++_current, ++_digits)
+		_mantissa = _mantissa * 10 + (*_current - '0');
+
+	_anyDigit = _anyDigit || _digits;
+
+	if (_current != _end && *_current == '.')
+	{
+		++_current;
+
+		if (!_digits)
+		{
+			for (; _current != _end && *_current == '0'; ++_current, --_exponent)
+				_anyDigit = true;
+		}
+
+		for (; _current != _end && isDigit(*_current); ++_current, ++_digits, --_exponent)
+		{
+			_anyDigit = true;
+			_mantissa = _mantissa * 10 + (*_current - '0');
+		}
+	}
+
+	if (!_anyDigit)
+		return false;
+
+	if (_current != _end && (*_current == 'e' || *_current == 'E'))
+	{
+		++_current;
+
+		bool _negativeExponent = false;
+		if (_current != _end && (*_current == '-' || *_current == '+'))
+			_negativeExponent = *_current++ == '-';
+
+		if (_current == _end || !isDigit(*_current))
+			return false;
+
+		int _written = 0;
+		for (; _current != _end && isDigit(*_current); ++_current)
+		{
+			if (_written < 10000)
+				_written = _written * 10 + (*_current - '0');
+		}
+
+		_exponent += _negativeExponent ? -_written : _written;
+	}
+
+	if (_current != _end)
+		return false;
+
+	// up to 19 digits the mantissa hasn't overflowed, up to 2^53 it's exact in double
+	if (_digits <= 19 && _mantissa <= max_exact_mantissa && _exponent >= -22 && _exponent <= 22)
+	{
+		double _result = static_cast<double>(_mantissa);
+
+		if (_exponent < 0)
+			_result /= exact_powers_of_10[-_exponent];
+		else
+			_result *= exact_powers_of_10[_exponent];
+
+		_value = _negative ? -_result : _result;
+		return true;
+	}
+
+	double _result;
+
+	if (!slowParse(_start, _end, _result))
+		return false;
+
+	_value = _negative ? -_result : _result;
+	return true;
+}
+
+bool parseNumber(const char* _begin, const char* _end, long& _value)
+{
+	const char* _current = _begin;
+	bool _negative = false;
+
+	if (_current != _end && (*_current == '-' || *_current == '+'))
+		_negative = *_current++ == '-';
+
+	if (_current == _end)
+		return false;
+
+	// counted as unsigned, so the most negative value fits too
+	unsigned long _limit = _negative ? 0UL - static_cast<unsigned long>(std::numeric_limits<long>::min()) : static_cast<unsigned long>(std::numeric_limits<long>::max());
+	unsigned long _result = 0;
+
+	for (; _current != _end; ++_current)
+	{
+		if (!isDigit(*_current))
+			return false;
+
+		unsigned long _digit = *_current - '0';
+
+		if (_result > (_limit - _digit) / 10)
+			return false;
+
+		_result = _result * 10 + _digit;
+	}
+
+	_value = _negative ? static_cast<long>(0UL - _result) : static_cast<long>(_result);
+	return true;
+}
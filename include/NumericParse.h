@@ -0,0 +1,36 @@
+/*
+	Copyright (c) 2019 Maciej Goncerz <https://github.com/Paurin1>.
+	Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+	NumericParse.h file declares functions converting text to numbers. Some
+	of API's values, like prices of graphs, are numbers written as JSON
+	strings. Unlike std::stod these functions don't depend on the locale
+	and don't need a std::string, they read the characters in place.
+
+	Most prices have at most 15 significant digits and a small exponent,
+	those are converted exactly with a single multiplication or division.
+	Others fall back to std::from_chars or, where it's missing, strtod on
+	a copy in a local buffer.
+*/
+
+#ifndef NUMERICPARSE_H
+#define NUMERICPARSE_H
+
+/**
+	Parses a number like "-12.5", "1e-05" or "7"
+
+	@param _begin first character of the number
+	@param _end character after the number
+	@param _value result, unchanged on failure
+	@return false if the text is not entirely a number
+*/
+bool parseNumber(const char* _begin, const char* _end, double& _value);
+
+/**
+	Parses an integer like "-12" or "1550000000"
+
+	@return false if the text is not entirely an integer or doesn't fit in long
+*/
+bool parseNumber(const char* _begin, const char* _end, long& _value);
+
+#endif
@@ -0,0 +1,187 @@
+/*
+	Copyright (c) 2019 Maciej Goncerz <https://github.com/Paurin1>.
+	Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+	PrivateApiDataStructures.h file contains definitions of data structures that are
+	used to represent output of BitmarketPrivate class "...Typed" functions.
+
+	Structures self-define themselves. Variable names correspond to those used by Bitmarket API.
+
+	Amounts, rates, fiat values and commissions are Decimal, read exactly
+	as the API wrote them.
+
+	Every structure begins with the common part of private responses:
+	success flag, error code and message, time and the limit of commands.
+	The whole response is still available as JSON through JsonView, which
+	keeps the response body and parses it on the first request only.
+*/
+
+#ifndef PRIVATEAPIDATASTRUCTURES_H
+#define PRIVATEAPIDATASTRUCTURES_H
+
+#include <vector>	// vector
+#include <string>	// string
+#include <map>		// map
+#include <memory>	// shared_ptr, make_shared, atomic_load, atomic_store
+
+// Fixed-point amounts and rates
+#include "Decimal.h"
+
+// Memory the response body has been read into
+#include "ResponseBuffer.h"
+
+// Single file library to handle JSON data format
+#include "nlohmann/json.hpp"
+
+/**
+	JSON document of a response, parsed when it's needed for the first time
+*/
+class JsonView
+{
+public:
+	JsonView() { }
+
+	/**
+		@param _body response body, kept as long as the view or any of its copies
+	*/
+	explicit JsonView(std::shared_ptr<const ResponseBuffer> _body) : m_body(_body) { }
+
+	/**
+		Returns the document, parsing the body only the first time
+
+		@return nullptr if there's no body or it's not valid JSON
+	*/
+	std::shared_ptr<const nlohmann::json> get() const
+	{
+		std::shared_ptr<const nlohmann::json> _json = std::atomic_load(&m_json);
+
+		if (_json || !m_body)
+			return _json;
+
+		try
+		{
+			_json = std::make_shared<const nlohmann::json>(nlohmann::json::parse(m_body->data(), m_body->data() + m_body->size()));
+		}
+		catch (...)
+		{
+			return nullptr;
+		}
+
+		// threads calling at once may each parse it, one of the documents is kept
+		std::atomic_store(&m_json, _json);
+		return _json;
+	}
+
+	/**
+		Returns copy of the response body
+	*/
+	std::string str() const
+	{
+		return m_body ? m_body->str() : std::string();
+	}
+
+private:
+	std::shared_ptr<const ResponseBuffer> m_body;
+	mutable std::shared_ptr<const nlohmann::json> m_json;
+};
+
+struct s_commandLimit
+{
+	long used;			// -1 if the response has no limit
+	long allowed;
+	long expires;		// seconds since Unix epoch
+};
+
+struct s_privateResponse
+{
+	bool success;
+	int error;				// 0 if there's no error
+	std::string errorMsg;
+	long time;
+	s_commandLimit limit;
+	JsonView json;			// the whole response
+};
+
+struct s_balances
+{
+	std::map<std::string, Decimal> available;	// currency -> amount
+	std::map<std::string, Decimal> blocked;
+};
+
+struct s_accountInfo : s_privateResponse
+{
+	s_balances balances;
+	Decimal turnover;
+	Decimal commissionMaker;
+	Decimal commissionTaker;
+};
+
+struct s_userOrder
+{
+	long id;
+	std::string market;
+	Decimal amount;
+	Decimal rate;
+	Decimal fiat;
+	std::string type;
+	long time;
+};
+
+struct s_tradeResult : s_privateResponse
+{
+	long id;
+	s_userOrder order;
+	s_balances balances;
+};
+
+struct s_cancelResult : s_privateResponse
+{
+	s_balances balances;
+};
+
+struct s_userOrders : s_privateResponse
+{
+	std::vector<s_userOrder> buy;
+	std::vector<s_userOrder> sell;
+};
+
+struct s_userTrade
+{
+	long id;
+	std::string type;
+	Decimal amountCrypto;
+	std::string currencyCrypto;
+	Decimal amountFiat;
+	std::string currencyFiat;
+	Decimal rate;
+	long time;
+};
+
+struct s_userTrades : s_privateResponse
+{
+	long total;
+	long start;
+	long count;
+	std::vector<s_userTrade> results;
+};
+
+struct s_historyEntry
+{
+	long id;
+	Decimal amount;
+	std::string currency;
+	Decimal rate;			// 0 if the operation is not a trade
+	Decimal commission;
+	long time;
+	std::string type;
+};
+
+struct s_history : s_privateResponse
+{
+	long total;
+	long start;
+	long count;
+	std::vector<s_historyEntry> results;
+};
+
+#endif
@@ -0,0 +1,530 @@
+/*
+	Copyright (c) 2019 Maciej Goncerz <https://github.com/Paurin1>.
+	Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+	More detailed descriptions are in PrivateApiParsers.h file.
+
+	One SAX handler serves every response. It keeps the path of keys
+	leading to the current value, each key turned into e_key once when it's
+	read, and reads the common part of the response itself. Values inside
+	"data" are handed to fill() overloads of the result's type together with
+	the path below "data". Keys it doesn't know are skipped.
+
+	Numbers written as strings are accepted, other values of an unexpected
+	type make the whole parsing fail. Null leaves the field unchanged.
+*/
+
+#include "PrivateApiParsers.h"
+
+// Locale-independent conversion of numbers written as strings
+#include "NumericParse.h"
+
+namespace
+{
+	typedef nlohmann::json json;
+
+	/**
+		Keys of private responses, anything else is k_other
+	*/
+	enum e_key
+	{
+		k_other,
+		k_item,				// element of an array
+		k_success,
+		k_error,
+		k_errorMsg,
+		k_time,
+		k_limit,
+		k_used,
+		k_allowed,
+		k_expires,
+		k_data,
+		k_balances,
+		k_available,
+		k_blocked,
+		k_account,
+		k_turnover,
+		k_commissionMaker,
+		k_commissionTaker,
+		k_id,
+		k_order,
+		k_market,
+		k_amount,
+		k_rate,
+		k_fiat,
+		k_type,
+		k_buy,
+		k_sell,
+		k_total,
+		k_start,
+		k_count,
+		k_results,
+		k_amountCrypto,
+		k_currencyCrypto,
+		k_amountFiat,
+		k_currencyFiat,
+		k_currency,
+		k_commission
+	};
+
+	e_key keyOf(const std::string& _key)
+	{
+		// std::string compares lengths first, most keys are rejected at once
+		static const std::pair<std::string, e_key> _keys[] =
+		{
+			{ "success", k_success },			{ "error", k_error },				{ "errorMsg", k_errorMsg },
+			{ "time", k_time },					{ "limit", k_limit },				{ "used", k_used },
+			{ "allowed", k_allowed },			{ "expires", k_expires },			{ "data", k_data },
+			{ "balances", k_balances },			{ "available", k_available },		{ "blocked", k_blocked },
+			{ "account", k_account },			{ "turnover", k_turnover },			{ "commissionMaker", k_commissionMaker },
+			{ "commissionTaker", k_commissionTaker }, { "id", k_id },				{ "order", k_order },
+			{ "market", k_market },				{ "amount", k_amount },				{ "rate", k_rate },
+			{ "fiat", k_fiat },					{ "type", k_type },					{ "buy", k_buy },
+			{ "sell", k_sell },					{ "total", k_total },				{ "start", k_start },
+			{ "count", k_count },				{ "results", k_results },			{ "amountCrypto", k_amountCrypto },
+			{ "currencyCrypto", k_currencyCrypto }, { "amountFiat", k_amountFiat },	{ "currencyFiat", k_currencyFiat },
+			{ "currency", k_currency },			{ "commission", k_commission }
+		};
+
+		for (const auto& _entry : _keys)
+		{
+			if (_key == _entry.first)
+				return _entry.second;
+		}
+
+		return k_other;
+	}
+
+	/**
+		Scalar value read by the handler
+	*/
+	struct s_value
+	{
+		enum e_type
+		{
+			e_null,
+			e_boolean,
+			e_integer,
+			e_float,
+			e_string
+		};
+
+		e_type type;
+		bool flag;
+		long long integer;
+		double real;
+		std::string* text;
+		const std::string* literal;	// float as written in the response
+	};
+
+	/**
+		Stores the value in a field of given type, false if it doesn't fit
+	*/
+	bool assign(const s_value& _value, Decimal& _field)
+	{
+		// floats are parsed from their text, the double would lose the last digits
+		switch (_value.type)
+		{
+		case s_value::e_null:		return true;
+		case s_value::e_integer:	_field = Decimal::fromInteger(_value.integer); return true;
+		case s_value::e_float:		return Decimal::parse(*_value.literal, _field);
+		case s_value::e_string:		return Decimal::parse(*_value.text, _field);
+		default:					return false;
+		}
+	}
+
+	bool assign(const s_value& _value, long& _field)
+	{
+		switch (_value.type)
+		{
+		case s_value::e_null:		return true;
+		case s_value::e_integer:	_field = static_cast<long>(_value.integer); return true;
+		case s_value::e_float:		_field = static_cast<long>(_value.real); return true;
+		case s_value::e_string:		return parseNumber(_value.text->data(), _value.text->data() + _value.text->size(), _field);
+		default:					return false;
+		}
+	}
+
+	bool assign(const s_value& _value, int& _field)
+	{
+		long _result = _field;
+
+		if (!assign(_value, _result))
+			return false;
+
+		_field = static_cast<int>(_result);
+		return true;
+	}
+
+	bool assign(const s_value& _value, bool& _field)
+	{
+		if (_value.type == s_value::e_boolean)
+			_field = _value.flag;
+		else if (_value.type == s_value::e_integer)
+			_field = _value.integer != 0;
+		else if (_value.type != s_value::e_null)
+			return false;
+
+		return true;
+	}
+
+	bool assign(const s_value& _value, std::string& _field)
+	{
+		if (_value.type == s_value::e_string)
+			_field.swap(*_value.text);
+		else if (_value.type != s_value::e_null)
+			return false;
+
+		return true;
+	}
+
+	/*
+		fill() overloads store a value found at _path (keys below "data",
+		_size of them) in the result. begin() is called when a container
+		starts at _path, so elements of lists are added before their fields.
+		_name is the last key as written in the response.
+	*/
+
+	bool fill(s_balances& _balances, const e_key* _path, int _size, const s_value& _value, const std::string& _name)
+	{
+		// {"available":{"PLN":..,"BTC":..},"blocked":{..}}
+		if (_size != 2)
+			return true;
+
+		if (_path[0] == k_available)
+			return assign(_value, _balances.available[_name]);
+
+		if (_path[0] == k_blocked)
+			return assign(_value, _balances.blocked[_name]);
+
+		return true;
+	}
+
+	bool fill(s_userOrder& _order, e_key _key, const s_value& _value)
+	{
+		switch (_key)
+		{
+		case k_id:		return assign(_value, _order.id);
+		case k_market:	return assign(_value, _order.market);
+		case k_amount:	return assign(_value, _order.amount);
+		case k_rate:	return assign(_value, _order.rate);
+		case k_fiat:	return assign(_value, _order.fiat);
+		case k_type:	return assign(_value, _order.type);
+		case k_time:	return assign(_value, _order.time);
+		default:		return true;
+		}
+	}
+
+	bool fill(s_userTrade& _trade, e_key _key, const s_value& _value)
+	{
+		switch (_key)
+		{
+		case k_id:				return assign(_value, _trade.id);
+		case k_type:			return assign(_value, _trade.type);
+		case k_amountCrypto:	return assign(_value, _trade.amountCrypto);
+		case k_currencyCrypto:	return assign(_value, _trade.currencyCrypto);
+		case k_amountFiat:		return assign(_value, _trade.amountFiat);
+		case k_currencyFiat:	return assign(_value, _trade.currencyFiat);
+		case k_rate:			return assign(_value, _trade.rate);
+		case k_time:			return assign(_value, _trade.time);
+		default:				return true;
+		}
+	}
+
+	bool fill(s_historyEntry& _entry, e_key _key, const s_value& _value)
+	{
+		switch (_key)
+		{
+		case k_id:			return assign(_value, _entry.id);
+		case k_amount:		return assign(_value, _entry.amount);
+		case k_currency:	return assign(_value, _entry.currency);
+		case k_rate:		return assign(_value, _entry.rate);
+		case k_commission:	return assign(_value, _entry.commission);
+		case k_time:		return assign(_value, _entry.time);
+		case k_type:		return assign(_value, _entry.type);
+		default:			return true;
+		}
+	}
+
+	/**
+		Fills total, start, count and results of a paged list
+	*/
+	template <typename List>
+	bool fillList(List& _list, const e_key* _path, int _size, const s_value& _value)
+	{
+		if (_size == 1)
+		{
+			switch (_path[0])
+			{
+			case k_total:	return assign(_value, _list.total);
+			case k_start:	return assign(_value, _list.start);
+			case k_count:	return assign(_value, _list.count);
+			default:		return true;
+			}
+		}
+
+		if (_size == 3 && _path[0] == k_results && _path[1] == k_item && !_list.results.empty())
+			return fill(_list.results.back(), _path[2], _value);
+
+		return true;
+	}
+
+	template <typename List>
+	void beginList(List& _list, const e_key* _path, int _size)
+	{
+		if (_size != 2 || _path[0] != k_results || _path[1] != k_item)
+			return;
+
+		// count is written before the list
+		if (_list.results.empty() && _list.count > 0)
+			_list.results.reserve(static_cast<size_t>(_list.count));
+
+		_list.results.emplace_back();
+	}
+
+	bool fill(s_accountInfo& _result, const e_key* _path, int _size, const s_value& _value, const std::string& _name)
+	{
+		if (_size > 0 && _path[0] == k_balances)
+			return fill(_result.balances, _path + 1, _size - 1, _value, _name);
+
+		if (_size != 2 || _path[0] != k_account)
+			return true;
+
+		switch (_path[1])
+		{
+		case k_turnover:		return assign(_value, _result.turnover);
+		case k_commissionMaker:	return assign(_value, _result.commissionMaker);
+		case k_commissionTaker:	return assign(_value, _result.commissionTaker);
+		default:				return true;
+		}
+	}
+
+	void begin(s_accountInfo&, const e_key*, int) { }
+
+	bool fill(s_tradeResult& _result, const e_key* _path, int _size, const s_value& _value, const std::string& _name)
+	{
+		if (_size > 0 && _path[0] == k_balances)
+			return fill(_result.balances, _path + 1, _size - 1, _value, _name);
+
+		if (_size == 1 && _path[0] == k_id)
+			return assign(_value, _result.id);
+
+		if (_size == 2 && _path[0] == k_order)
+			return fill(_result.order, _path[1], _value);
+
+		return true;
+	}
+
+	void begin(s_tradeResult&, const e_key*, int) { }
+
+	bool fill(s_cancelResult& _result, const e_key* _path, int _size, const s_value& _value, const std::string& _name)
+	{
+		if (_size > 0 && _path[0] == k_balances)
+			return fill(_result.balances, _path + 1, _size - 1, _value, _name);
+
+		return true;
+	}
+
+	void begin(s_cancelResult&, const e_key*, int) { }
+
+	bool fill(s_userOrders& _result, const e_key* _path, int _size, const s_value& _value, const std::string&)
+	{
+		// {"buy":[{order},..],"sell":[{order},..]}
+		if (_size != 3 || _path[1] != k_item)
+			return true;
+
+		std::vector<s_userOrder>* _side = _path[0] == k_buy ? &_result.buy : _path[0] == k_sell ? &_result.sell : nullptr;
+
+		if (!_side || _side->empty())
+			return true;
+
+		return fill(_side->back(), _path[2], _value);
+	}
+
+	void begin(s_userOrders& _result, const e_key* _path, int _size)
+	{
+		if (_size != 2 || _path[1] != k_item)
+			return;
+
+		if (_path[0] == k_buy)
+			_result.buy.emplace_back();
+		else if (_path[0] == k_sell)
+			_result.sell.emplace_back();
+	}
+
+	bool fill(s_userTrades& _result, const e_key* _path, int _size, const s_value& _value, const std::string&)
+	{
+		return fillList(_result, _path, _size, _value);
+	}
+
+	void begin(s_userTrades& _result, const e_key* _path, int _size)
+	{
+		beginList(_result, _path, _size);
+	}
+
+	bool fill(s_history& _result, const e_key* _path, int _size, const s_value& _value, const std::string&)
+	{
+		return fillList(_result, _path, _size, _value);
+	}
+
+	void begin(s_history& _result, const e_key* _path, int _size)
+	{
+		beginList(_result, _path, _size);
+	}
+
+	/**
+		Reads the common part of the response and passes "data" to fill() of the result
+	*/
+	template <typename Result>
+	class PrivateHandler
+	{
+	public:
+		PrivateHandler(Result& _result) : m_result(_result), m_depth(0)
+		{
+			m_result.success = false;
+			m_result.error = 0;
+			m_result.limit = { -1, -1, -1 };
+		}
+
+		bool null()												{ return value({ s_value::e_null, false, 0, 0.0, nullptr, nullptr }); }
+		bool boolean(bool _value)								{ return value({ s_value::e_boolean, _value, 0, 0.0, nullptr, nullptr }); }
+		bool number_integer(json::number_integer_t _value)		{ return value({ s_value::e_integer, false, _value, 0.0, nullptr, nullptr }); }
+		bool number_unsigned(json::number_unsigned_t _value)	{ return value({ s_value::e_integer, false, static_cast<long long>(_value), 0.0, nullptr, nullptr }); }
+		bool number_float(json::number_float_t _value, const json::string_t& _text) { return value({ s_value::e_float, false, 0, _value, nullptr, &_text }); }
+		bool string(json::string_t& _value)						{ return value({ s_value::e_string, false, 0, 0.0, &_value, nullptr }); }
+
+		bool start_object(std::size_t)	{ return open(false); }
+		bool start_array(std::size_t)	{ return open(true); }
+		bool end_object()				{ --m_depth; return true; }
+		bool end_array()				{ --m_depth; return true; }
+
+		bool key(json::string_t& _key)
+		{
+			if (m_depth <= max_depth)
+			{
+				m_path[m_depth - 1] = keyOf(_key);
+				m_name.swap(_key);
+			}
+
+			return true;
+		}
+
+		bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception&)
+		{
+			return false;
+		}
+
+	private:
+		// values nested deeper are skipped
+		static const int max_depth = 8;
+
+		bool open(bool _array)
+		{
+			// the document must be an object
+			if (m_depth == 0 && _array)
+				return false;
+
+			if (m_depth >= 2 && m_depth <= max_depth && m_path[0] == k_data)
+				begin(m_result, m_path + 1, m_depth - 1);
+
+			if (++m_depth <= max_depth)
+				m_path[m_depth - 1] = _array ? k_item : k_other;
+
+			return true;
+		}
+
+		bool value(const s_value& _value)
+		{
+			if (m_depth == 0)
+				return false;
+
+			if (m_depth > max_depth)
+				return true;
+
+			if (m_depth == 1)
+			{
+				switch (m_path[0])
+				{
+				case k_success:		return assign(_value, m_result.success);
+				case k_error:		return assign(_value, m_result.error);
+				case k_errorMsg:	return assign(_value, m_result.errorMsg);
+				case k_time:		return assign(_value, m_result.time);
+				default:			return true;
+				}
+			}
+
+			if (m_path[0] == k_data)
+				return fill(m_result, m_path + 1, m_depth - 1, _value, m_name);
+
+			if (m_depth == 2 && m_path[0] == k_limit)
+			{
+				switch (m_path[1])
+				{
+				case k_used:		return assign(_value, m_result.limit.used);
+				case k_allowed:		return assign(_value, m_result.limit.allowed);
+				case k_expires:		return assign(_value, m_result.limit.expires);
+				default:			return true;
+				}
+			}
+
+			return true;
+		}
+
+		Result& m_result;
+
+		// m_path[i] is the key of the current value in the container at depth i + 1
+		e_key m_path[max_depth];
+		int m_depth;
+
+		// the last key as written, currencies of balances are kept from it
+		std::string m_name;
+	};
+
+	/**
+		Runs the handler over the body, false on any error
+	*/
+	template <typename Result>
+	bool parseWith(const char* _data, size_t _size, Result& _result)
+	{
+		PrivateHandler<Result> _handler(_result);
+
+		try
+		{
+			return json::sax_parse(_data, _data + _size, &_handler);
+		}
+		catch (...)
+		{
+			return false;
+		}
+	}
+}
+
+bool parsePrivateResponse(const char* _data, size_t _size, s_accountInfo& _result)
+{
+	return parseWith(_data, _size, _result);
+}
+
+bool parsePrivateResponse(const char* _data, size_t _size, s_tradeResult& _result)
+{
+	return parseWith(_data, _size, _result);
+}
+
+bool parsePrivateResponse(const char* _data, size_t _size, s_cancelResult& _result)
+{
+	return parseWith(_data, _size, _result);
+}
+
+bool parsePrivateResponse(const char* _data, size_t _size, s_userOrders& _result)
+{
+	return parseWith(_data, _size, _result);
+}
+
+bool parsePrivateResponse(const char* _data, size_t _size, s_userTrades& _result)
+{
+	return parseWith(_data, _size, _result);
+}
+
+bool parsePrivateResponse(const char* _data, size_t _size, s_history& _result)
+{
+	return parseWith(_data, _size, _result);
+}
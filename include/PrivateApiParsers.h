@@ -0,0 +1,57 @@
+/*
+	Copyright (c) 2019 Maciej Goncerz <https://github.com/Paurin1>.
+	Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+	PrivateApiParsers.h file declares functions that parse private API's
+	responses straight into structures from PrivateApiDataStructures.h.
+	Like PublicApiParsers, they are driven by nlohmann::json's SAX
+	interface, so no JSON document is built on the way.
+
+	Fields missing from the response keep their zero value, limit's fields
+	are -1. JsonView of the result is left empty, the caller sets it.
+*/
+
+#ifndef PRIVATEAPIPARSERS_H
+#define PRIVATEAPIPARSERS_H
+
+#include <cstddef>	// size_t
+
+// Defines structures that are used to store private API's data
+#include "PrivateApiDataStructures.h"
+
+/**
+	Parses response of info command
+
+	@param _data beginning of the response body
+	@param _size length of the response body
+	@param _result structure the response is stored in
+	@return false if the body is not a valid response
+*/
+bool parsePrivateResponse(const char* _data, size_t _size, s_accountInfo& _result);
+
+/**
+	Parses response of trade command
+*/
+bool parsePrivateResponse(const char* _data, size_t _size, s_tradeResult& _result);
+
+/**
+	Parses response of cancel command
+*/
+bool parsePrivateResponse(const char* _data, size_t _size, s_cancelResult& _result);
+
+/**
+	Parses response of orders command
+*/
+bool parsePrivateResponse(const char* _data, size_t _size, s_userOrders& _result);
+
+/**
+	Parses response of trades command
+*/
+bool parsePrivateResponse(const char* _data, size_t _size, s_userTrades& _result);
+
+/**
+	Parses response of history command
+*/
+bool parsePrivateResponse(const char* _data, size_t _size, s_history& _result);
+
+#endif
@@ -0,0 +1,239 @@
+/*
+	Copyright (c) 2019 Maciej Goncerz <https://github.com/Paurin1>.
+	Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+	More detailed descriptions are in PrivateCommandDispatcher.h file.
+*/
+
+#include "PrivateCommandDispatcher.h"
+
+#include <algorithm>	// min, max
+
+namespace
+{
+	// 2^16 ms is over a minute, anything longer lands in the last bucket
+	const size_t histogram_buckets = 17;
+}
+
+double PrivateCommandDispatcher::s_latencyHistogram::percentile(double _percentile) const
+{
+	if (!count)
+		return 0;
+
+	double _wanted = count * _percentile / 100;
+	unsigned long _counted = 0;
+
+	for (size_t i = 0; i < buckets.size(); ++i)
+	{
+		_counted += buckets[i];
+
+		if (_counted >= _wanted)
+			return i + 1 < buckets.size() ? static_cast<double>(1UL << i) : maxMs;
+	}
+
+	return maxMs;
+}
+
+PrivateCommandDispatcher::PrivateCommandDispatcher(BitmarketPrivate& _api, size_t _classes, std::shared_ptr<IoExecutor> _executor) :
+	m_api(_api), m_executor(_executor ? _executor : IoExecutor::shared()),
+	m_queues(std::max<size_t>(_classes, 1)), m_histograms(std::max<size_t>(_classes, 1)), m_inFlight(0), m_stopping(false)
+{
+	for (s_latencyHistogram& _histogram : m_histograms)
+		_histogram = { std::vector<unsigned long>(histogram_buckets), 0, 0, 0 };
+
+	// latency-critical methods first, bulk ones last
+	size_t _last = m_queues.size() - 1;
+
+	m_priorities["cancel"]	= 0;
+	m_priorities["trade"]	= 0;
+	m_priorities["orders"]	= std::min<size_t>(1, _last);
+	m_priorities["info"]	= _last;
+	m_priorities["history"]	= _last;
+	m_priorities["trades"]	= _last;
+
+	m_thread = std::thread(&PrivateCommandDispatcher::f_dispatch, this);
+}
+
+PrivateCommandDispatcher::~PrivateCommandDispatcher()
+{
+	std::vector<s_command> _abandoned;
+
+	{
+		std::unique_lock<std::mutex> _lock(m_mutex);
+		m_stopping = true;
+
+		for (auto& _queue : m_queues)
+		{
+			for (s_command& _command : _queue)
+				_abandoned.push_back(std::move(_command));
+
+			_queue.clear();
+		}
+	}
+
+	m_condition.notify_all();
+	m_thread.join();
+
+	for (s_command& _command : _abandoned)
+		_command.deliver();
+
+	// commands being sent refer to this object
+	std::unique_lock<std::mutex> _lock(m_mutex);
+	m_condition.wait(_lock, [this]() { return m_inFlight == 0; });
+}
+
+std::future<ptr_json> PrivateCommandDispatcher::submit(std::string _method, std::unordered_map<std::string, std::string> _arguments)
+{
+	auto _promise = std::make_shared<std::promise<ptr_json>>();
+	std::future<ptr_json> _future = _promise->get_future();
+
+	submit([_promise](ptr_json _response) { _promise->set_value(_response); }, _method, _arguments);
+
+	return _future;
+}
+
+void PrivateCommandDispatcher::submit(json_callback _callback, std::string _method, std::unordered_map<std::string, std::string> _arguments)
+{
+	auto _response = std::make_shared<ptr_json>();
+
+	f_queue(std::move(_method), std::move(_arguments),
+		[_response](BitmarketPrivate& _api, const std::string& _method, std::unordered_map<std::string, std::string>& _arguments)
+		{
+			*_response = _api.command(_method, _arguments, true);
+		},
+		[_response, _callback]() { _callback(*_response); });
+}
+
+void PrivateCommandDispatcher::f_queue(std::string _method, std::unordered_map<std::string, std::string> _arguments, send_function _send, std::function<void()> _deliver)
+{
+	{
+		std::lock_guard<std::mutex> _lock(m_mutex);
+
+		auto _found = m_priorities.find(_method);
+		size_t _class = _found != m_priorities.end() ? _found->second : m_queues.size() - 1;
+
+		m_queues[_class].push_back({ std::move(_method), std::move(_arguments), std::move(_send), std::move(_deliver), std::chrono::steady_clock::now() });
+	}
+
+	m_condition.notify_all();
+}
+
+void PrivateCommandDispatcher::priority(const std::string& _method, size_t _class)
+{
+	std::lock_guard<std::mutex> _lock(m_mutex);
+	m_priorities[_method] = std::min(_class, m_queues.size() - 1);
+}
+
+size_t PrivateCommandDispatcher::priority(const std::string& _method)
+{
+	std::lock_guard<std::mutex> _lock(m_mutex);
+
+	auto _found = m_priorities.find(_method);
+	return _found != m_priorities.end() ? _found->second : m_queues.size() - 1;
+}
+
+size_t PrivateCommandDispatcher::queued(size_t _class)
+{
+	std::lock_guard<std::mutex> _lock(m_mutex);
+	return _class < m_queues.size() ? m_queues[_class].size() : 0;
+}
+
+PrivateCommandDispatcher::s_latencyHistogram PrivateCommandDispatcher::histogram(size_t _class)
+{
+	std::lock_guard<std::mutex> _lock(m_mutex);
+	return m_histograms.at(_class);
+}
+
+void PrivateCommandDispatcher::f_dispatch()
+{
+	std::unique_lock<std::mutex> _lock(m_mutex);
+
+	while (!m_stopping)
+	{
+		auto _nonEmpty = [this]()
+		{
+			for (const auto& _queue : m_queues)
+			{
+				if (!_queue.empty())
+					return true;
+			}
+
+			return false;
+		};
+
+		if (!_nonEmpty())
+		{
+			m_condition.wait(_lock);
+			continue;
+		}
+
+		// the budget is shared with everyone using the key, the command is chosen
+		// only after a slot has been reserved so a later urgent one can overtake
+		std::shared_ptr<CommandLimiter> _limiter = m_api.limiter();
+
+		_lock.unlock();
+		std::chrono::milliseconds _wait = _limiter->reserve();
+		_lock.lock();
+
+		if (_wait.count() > 0)
+		{
+			m_condition.wait_for(_lock, _wait, [this]() { return m_stopping; });
+			continue;
+		}
+
+		for (size_t _class = 0; _class < m_queues.size(); ++_class)
+		{
+			if (m_queues[_class].empty())
+				continue;
+
+			s_command _command = std::move(m_queues[_class].front());
+			m_queues[_class].pop_front();
+			++m_inFlight;
+
+			_lock.unlock();
+			f_send(_class, std::move(_command));
+			_lock.lock();
+			break;
+		}
+	}
+}
+
+void PrivateCommandDispatcher::f_send(size_t _class, s_command _command)
+{
+	auto _shared = std::make_shared<s_command>(std::move(_command));
+
+	m_executor->post([this, _class, _shared]()
+	{
+		try
+		{
+			_shared->send(m_api, _shared->method, _shared->arguments);
+		}
+		catch (...)
+		{
+			// invalid JSON in the response, reported the same way as a connection error
+		}
+
+		double _elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - _shared->queued).count();
+
+		{
+			std::lock_guard<std::mutex> _lock(m_mutex);
+			s_latencyHistogram& _histogram = m_histograms[_class];
+
+			size_t _bucket = 0;
+			while (_bucket + 1 < _histogram.buckets.size() && _elapsed >= static_cast<double>(1UL << _bucket))
+				++_bucket;
+
+			++_histogram.buckets[_bucket];
+			++_histogram.count;
+			_histogram.totalMs += _elapsed;
+			_histogram.maxMs = std::max(_histogram.maxMs, _elapsed);
+
+			// notified under the lock, the destructor may return as soon as it's released
+			--m_inFlight;
+			m_condition.notify_all();
+		}
+
+		// the dispatcher is not touched anymore, the callback may even destroy it
+		_shared->deliver();
+	});
+}
@@ -0,0 +1,179 @@
+/*
+	Copyright (c) 2019 Maciej Goncerz <https://github.com/Paurin1>.
+	Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+	PrivateCommandDispatcher class queues private commands by urgency.
+	Every method belongs to a priority class, 0 being the most urgent.
+	Whenever the limit of commands (see CommandLimiter) allows to send
+	one, the oldest command of the most urgent non-empty class goes first,
+	so cancels and trades overtake history pages waiting for the budget.
+
+	By default "cancel" and "trade" are in class 0, "orders" in class 1
+	and "info", "history", "trades" and unknown methods in the last one.
+	Latency of every class, from queuing till the response, is gathered
+	in a histogram.
+*/
+
+#ifndef PRIVATECOMMANDDISPATCHER_H
+#define PRIVATECOMMANDDISPATCHER_H
+
+#include <string>				// string
+#include <vector>				// vector
+#include <deque>				// deque
+#include <unordered_map>		// unordered_map
+#include <memory>				// shared_ptr
+#include <thread>				// thread
+#include <mutex>				// mutex, unique_lock
+#include <condition_variable>	// condition_variable
+#include <future>				// future, promise
+#include <chrono>				// steady_clock
+#include <functional>			// function
+
+// Private API whose command() sends the requests
+#include "BitmarketPrivate.h"
+
+class PrivateCommandDispatcher
+{
+public:
+	/**
+		Latencies of one priority class
+	*/
+	struct s_latencyHistogram
+	{
+		// bucket i counts commands that took less than 2^i milliseconds, the last one also longer ones
+		std::vector<unsigned long> buckets;
+		unsigned long count;
+		double totalMs;
+		double maxMs;
+
+		/**
+			Returns upper bound of the bucket containing given percentile in milliseconds
+
+			@param _percentile value from 0 to 100
+		*/
+		double percentile(double _percentile) const;
+	};
+
+	/**
+		Starts dispatching thread
+
+		@param _api object commands are sent through, must outlive the dispatcher
+		@param _classes number of priority classes
+		@param _executor threads sending commands, IoExecutor::shared() by default
+	*/
+	PrivateCommandDispatcher(BitmarketPrivate& _api, size_t _classes = 3, std::shared_ptr<IoExecutor> _executor = nullptr);
+
+	/**
+		Fails queued commands with nullptr and waits for those being sent
+	*/
+	~PrivateCommandDispatcher();
+
+	PrivateCommandDispatcher(const PrivateCommandDispatcher&) = delete;
+	PrivateCommandDispatcher& operator=(const PrivateCommandDispatcher&) = delete;
+
+	/**
+		Queues a command, see BitmarketPrivate::command()
+
+		@return future of API's response, nullptr on error
+	*/
+	std::future<ptr_json> submit(std::string _method, std::unordered_map<std::string, std::string> _arguments);
+
+	/**
+		Queues a command, given callback is called from executor's thread with the response
+	*/
+	void submit(json_callback _callback, std::string _method, std::unordered_map<std::string, std::string> _arguments);
+
+	/**
+		Queues a command whose response is parsed into Result, see BitmarketPrivate::commandTyped()
+
+		@return future of the parsed response, nullptr on error
+	*/
+	template <typename Result>
+	std::future<std::shared_ptr<Result>> submitTyped(std::string _method, std::unordered_map<std::string, std::string> _arguments)
+	{
+		auto _promise = std::make_shared<std::promise<std::shared_ptr<Result>>>();
+		std::future<std::shared_ptr<Result>> _future = _promise->get_future();
+
+		submitTyped<Result>([_promise](std::shared_ptr<Result> _response) { _promise->set_value(_response); }, std::move(_method), std::move(_arguments));
+
+		return _future;
+	}
+
+	/**
+		Queues a command whose response is parsed into Result, given callback is called from executor's thread with it
+	*/
+	template <typename Result>
+	void submitTyped(std::function<void(std::shared_ptr<Result>)> _callback, std::string _method, std::unordered_map<std::string, std::string> _arguments)
+	{
+		auto _response = std::make_shared<std::shared_ptr<Result>>();
+
+		f_queue(std::move(_method), std::move(_arguments),
+			[_response](BitmarketPrivate& _api, const std::string& _method, std::unordered_map<std::string, std::string>& _arguments)
+			{
+				*_response = _api.commandTyped<Result>(_method, _arguments, true);
+			},
+			[_response, _callback]() { _callback(*_response); });
+	}
+
+	/**
+		Assigns method to a priority class, classes beyond the last one are clamped to it
+	*/
+	void priority(const std::string& _method, size_t _class);
+
+	/**
+		Returns priority class of given method
+	*/
+	size_t priority(const std::string& _method);
+
+	/**
+		Returns number of commands waiting in given class
+	*/
+	size_t queued(size_t _class);
+
+	/**
+		Returns copy of latency histogram of given class
+	*/
+	s_latencyHistogram histogram(size_t _class);
+
+private:
+	typedef std::function<void(BitmarketPrivate&, const std::string&, std::unordered_map<std::string, std::string>&)> send_function;
+
+	struct s_command
+	{
+		std::string method;
+		std::unordered_map<std::string, std::string> arguments;
+		send_function send;				// sends the reserved command and keeps the response
+		std::function<void()> deliver;	// passes the kept response to the caller, nullptr if it hasn't been sent
+		std::chrono::steady_clock::time_point queued;
+	};
+
+	/**
+		Puts a command into the queue of its method's class
+	*/
+	void f_queue(std::string _method, std::unordered_map<std::string, std::string> _arguments, send_function _send, std::function<void()> _deliver);
+
+	/**
+		Main loop of the dispatching thread
+	*/
+	void f_dispatch();
+
+	/**
+		Sends reserved command on the executor and records its latency
+	*/
+	void f_send(size_t _class, s_command _command);
+
+	BitmarketPrivate& m_api;
+	std::shared_ptr<IoExecutor> m_executor;
+
+	std::vector<std::deque<s_command>> m_queues;
+	std::vector<s_latencyHistogram> m_histograms;
+	std::unordered_map<std::string, size_t> m_priorities;
+	size_t m_inFlight;
+	bool m_stopping;
+
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+	std::thread m_thread;
+};
+
+#endif
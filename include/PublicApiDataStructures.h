@@ -6,12 +6,22 @@
 	used to represent output of BitmarketPublic class functions.
 
 	Structures self-define themselves. Variable names correspond to those used by Bitmarket API.
+
+	Structures with "fixed" in the name hold prices and amounts as Decimal,
+	exactly as the API has written them.
 */
 
 #ifndef PUBLICAPIDATASTRUCTURES_H
 #define PUBLICAPIDATASTRUCTURES_H
 
 #include <vector>
+#include <string>
+
+// Fixed-point number used by the "fixed" structures
+#include "Decimal.h"
+
+// Column by column storage of graph's points
+#include "CandleColumns.h"
 
 struct s_ticker
 {
@@ -36,6 +46,18 @@ struct s_orderBook
 	std::vector<s_order> bids;
 };
 
+struct s_fixedOrder
+{
+	Decimal exchangeRate;
+	Decimal amount;
+};
+
+struct s_fixedOrderBook
+{
+	std::vector<s_fixedOrder> asks;
+	std::vector<s_fixedOrder> bids;
+};
+
 struct s_trade
 {
 	double amount;
@@ -50,6 +72,20 @@ struct s_trades
 	std::vector<s_trade> trades;
 };
 
+struct s_fixedTrade
+{
+	Decimal amount;
+	Decimal price;
+	long date;			// seconds since Unix epoch
+	long tid;
+	std::string type;
+};
+
+struct s_fixedTrades
+{
+	std::vector<s_fixedTrade> trades;
+};
+
 struct s_graphPoint
 {
 	long time;
@@ -62,7 +98,7 @@ struct s_graphPoint
 
 struct s_graph
 {
-	std::vector<s_graphPoint> points;
+	CandleColumns points;	// points[i] is a view with the members of s_graphPoint, columns are in points.open() etc.
 	std::string m_market;
 	std::string m_interval;
 };
@@ -0,0 +1,599 @@
+/*
+	Copyright (c) 2019 Maciej Goncerz <https://github.com/Paurin1>.
+	Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+	More detailed descriptions are in PublicApiParsers.h file.
+
+	Every parser is a SAX handler that tracks how deep in the document it
+	is. Values of keys it doesn't know are skipped, values of an unexpected
+	type make the whole parsing fail just like get<>() would throw.
+
+	Handlers are templates filling either double or Decimal fields. Decimal
+	is parsed from the number's text as it appears in the body, so nothing
+	is lost on the way through double.
+*/
+
+#include "PublicApiParsers.h"
+
+// Locale-independent conversion of numbers written as strings
+#include "NumericParse.h"
+
+// Nlohmann's json library https://github.com/nlohmann/json
+#include "nlohmann/json.hpp"
+
+namespace
+{
+	typedef nlohmann::json json;
+
+	/**
+		Converts a number to the type of structure's field
+	*/
+	void fromInteger(long long _value, double& _result)		{ _result = static_cast<double>(_value); }
+	void fromInteger(long long _value, Decimal& _result)	{ _result = Decimal::fromInteger(_value); }
+
+	bool fromFloat(json::number_float_t _value, const json::string_t&, double& _result)
+	{
+		_result = _value;
+		return true;
+	}
+
+	bool fromFloat(json::number_float_t, const json::string_t& _text, Decimal& _result)
+	{
+		return Decimal::parse(_text, _result);
+	}
+
+	/**
+		Common part of SAX handlers: skipping of unknown values and error handling
+	*/
+	class SaxHandler
+	{
+	public:
+		SaxHandler() : m_depth(0), m_skip(0) { }
+
+		bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception&)
+		{
+			return false;
+		}
+
+	protected:
+		/**
+			Skips given container, including everything nested in it
+		*/
+		bool skipContainer()
+		{
+			m_skip = 1;
+			return true;
+		}
+
+		// depth of the currently parsed container, 0 is outside of the document
+		int m_depth;
+
+		// depth inside of a skipped container, 0 if nothing is skipped
+		int m_skip;
+	};
+
+	/**
+		Fills s_orderBook or s_fixedOrderBook from {"asks":[[rate,amount],...],"bids":[[rate,amount],...]}
+	*/
+	template <typename OrderBook>
+	class OrderBookHandler : public SaxHandler
+	{
+		typedef typename decltype(OrderBook::asks)::value_type Order;
+		typedef decltype(Order::amount) Value;
+
+	public:
+		OrderBookHandler(OrderBook& _orderBook) : m_orderBook(_orderBook), m_side(nullptr), m_order(), m_index(0) { }
+
+		bool null()									{ return value(false, Value()); }
+		bool boolean(bool)							{ return value(false, Value()); }
+		bool string(json::string_t&)				{ return value(false, Value()); }
+
+		bool number_integer(json::number_integer_t _value)
+		{
+			Value _result;
+			fromInteger(_value, _result);
+			return value(true, _result);
+		}
+
+		bool number_unsigned(json::number_unsigned_t _value)
+		{
+			Value _result;
+			fromInteger(static_cast<long long>(_value), _result);
+			return value(true, _result);
+		}
+
+		bool number_float(json::number_float_t _value, const json::string_t& _text)
+		{
+			Value _result = Value();
+
+			// text of skipped values is not even read
+			if (!m_skip && m_depth == 3 && !fromFloat(_value, _text, _result))
+				return false;
+
+			return value(true, _result);
+		}
+
+		bool start_object(std::size_t)	{ return open(false); }
+		bool start_array(std::size_t)	{ return open(true); }
+		bool end_object()				{ return close(); }
+		bool end_array()				{ return close(); }
+
+		bool key(json::string_t& _key)
+		{
+			if (!m_skip && m_depth == 1)
+				m_side = _key == "asks" ? &m_orderBook.asks : _key == "bids" ? &m_orderBook.bids : nullptr;
+
+			return true;
+		}
+
+	private:
+		bool open(bool _array)
+		{
+			if (m_skip)
+			{
+				++m_skip;
+				return true;
+			}
+
+			switch (m_depth)
+			{
+			case 0:
+				// the document must be an object
+				if (_array)
+					return false;
+				break;
+
+			case 1:
+				// only asks and bids arrays are read
+				if (!_array || !m_side)
+					return skipContainer();
+				break;
+
+			case 2:
+				// every order is a [rate, amount] array
+				if (!_array)
+					return false;
+				m_index = 0;
+				break;
+
+			default:
+				return false;
+			}
+
+			++m_depth;
+			return true;
+		}
+
+		bool close()
+		{
+			if (m_skip)
+			{
+				--m_skip;
+				return true;
+			}
+
+			if (m_depth == 3)
+			{
+				if (m_index < 2)
+					return false;
+
+				m_side->push_back(m_order);
+			}
+
+			--m_depth;
+			return true;
+		}
+
+		bool value(bool _number, Value _value)
+		{
+			// values of other keys are ignored
+			if (m_skip || m_depth == 1)
+				return true;
+
+			if (m_depth != 3 || !_number)
+				return false;
+
+			if (m_index == 0)
+				m_order.exchangeRate = _value;
+			else if (m_index == 1)
+				m_order.amount = _value;
+
+			++m_index;
+			return true;
+		}
+
+		OrderBook& m_orderBook;
+		std::vector<Order>* m_side;
+		Order m_order;
+		int m_index;
+	};
+
+	/**
+		Fills s_trades or s_fixedTrades from [{"amount":..,"price":..,"date":..,"tid":..,"type":".."},...]
+	*/
+	template <typename Trades>
+	class TradesHandler : public SaxHandler
+	{
+		typedef typename decltype(Trades::trades)::value_type Trade;
+		typedef decltype(Trade::amount) Value;
+
+	public:
+		TradesHandler(Trades& _trades) : m_trades(_trades), m_trade(), m_field(f_other), m_fields(0) { }
+
+		bool null()											{ return m_skip || (m_depth == 2 && m_field == f_other); }
+		bool boolean(bool)									{ return m_skip || (m_depth == 2 && m_field == f_other); }
+
+		bool number_integer(json::number_integer_t _value)
+		{
+			Value _result;
+			fromInteger(_value, _result);
+			return number(_result, static_cast<long>(_value));
+		}
+
+		bool number_unsigned(json::number_unsigned_t _value)
+		{
+			Value _result;
+			fromInteger(static_cast<long long>(_value), _result);
+			return number(_result, static_cast<long>(_value));
+		}
+
+		bool number_float(json::number_float_t _value, const json::string_t& _text)
+		{
+			Value _result = Value();
+
+			// only amount and price are read from the text
+			if (!m_skip && m_depth == 2 && (m_field == f_amount || m_field == f_price) && !fromFloat(_value, _text, _result))
+				return false;
+
+			return number(_result, static_cast<long>(_value));
+		}
+
+		bool string(json::string_t& _value)
+		{
+			if (m_skip)
+				return true;
+
+			if (m_depth != 2)
+				return false;
+
+			if (m_field == f_type)
+			{
+				m_trade.type.swap(_value);
+				m_fields |= f_type;
+			}
+
+			return m_field == f_type || m_field == f_other;
+		}
+
+		bool start_object(std::size_t)
+		{
+			if (m_skip)
+			{
+				++m_skip;
+				return true;
+			}
+
+			// every trade is an object placed directly in the top array
+			if (m_depth == 1)
+			{
+				m_fields = 0;
+				m_depth = 2;
+				return true;
+			}
+
+			return m_depth == 2 && m_field == f_other ? skipContainer() : false;
+		}
+
+		bool start_array(std::size_t)
+		{
+			if (m_skip)
+			{
+				++m_skip;
+				return true;
+			}
+
+			// the document must be an array
+			if (m_depth == 0)
+			{
+				m_depth = 1;
+				return true;
+			}
+
+			return m_depth == 2 && m_field == f_other ? skipContainer() : false;
+		}
+
+		bool end_object()
+		{
+			if (m_skip)
+			{
+				--m_skip;
+				return true;
+			}
+
+			// every field is required
+			if (m_fields != f_all)
+				return false;
+
+			m_trades.trades.push_back(std::move(m_trade));
+			m_depth = 1;
+			return true;
+		}
+
+		bool end_array()
+		{
+			if (m_skip)
+			{
+				--m_skip;
+				return true;
+			}
+
+			m_depth = 0;
+			return true;
+		}
+
+		bool key(json::string_t& _key)
+		{
+			if (m_skip)
+				return true;
+
+			if (_key == "amount")		m_field = f_amount;
+			else if (_key == "price")	m_field = f_price;
+			else if (_key == "date")	m_field = f_date;
+			else if (_key == "tid")		m_field = f_tid;
+			else if (_key == "type")	m_field = f_type;
+			else						m_field = f_other;
+
+			return true;
+		}
+
+	private:
+		enum e_field
+		{
+			f_other		= 0,
+			f_amount	= 1 << 0,
+			f_price		= 1 << 1,
+			f_date		= 1 << 2,
+			f_tid		= 1 << 3,
+			f_type		= 1 << 4,
+			f_all		= f_amount | f_price | f_date | f_tid | f_type
+		};
+
+		bool number(Value _real, long _integer)
+		{
+			if (m_skip)
+				return true;
+
+			if (m_depth != 2)
+				return false;
+
+			switch (m_field)
+			{
+			case f_amount:	m_trade.amount = _real;		break;
+			case f_price:	m_trade.price = _real;		break;
+			case f_date:	m_trade.date = _integer;	break;
+			case f_tid:		m_trade.tid = _integer;		break;
+			case f_type:	return false;
+			default:		return true;
+			}
+
+			m_fields |= m_field;
+			return true;
+		}
+
+		Trades& m_trades;
+		Trade m_trade;
+		e_field m_field;
+		int m_fields;
+	};
+
+	/**
+		Fills s_graph from [{"time":..,"open":"..","high":"..","low":"..","close":"..","vol":".."},...]
+
+		Prices and volume are numbers written as strings, they're converted in
+		the parser's buffer. Plain numbers are accepted as well.
+	*/
+	class GraphHandler : public SaxHandler
+	{
+	public:
+		GraphHandler(s_graph& _graph) : m_graph(_graph), m_point(), m_field(f_other), m_fields(0) { }
+
+		bool null()											{ return m_skip || (m_depth == 2 && m_field == f_other); }
+		bool boolean(bool)									{ return m_skip || (m_depth == 2 && m_field == f_other); }
+		bool number_integer(json::number_integer_t _value)	{ return number(static_cast<double>(_value), static_cast<long>(_value)); }
+		bool number_unsigned(json::number_unsigned_t _value){ return number(static_cast<double>(_value), static_cast<long>(_value)); }
+		bool number_float(json::number_float_t _value, const json::string_t&) { return number(_value, static_cast<long>(_value)); }
+
+		bool string(json::string_t& _value)
+		{
+			if (m_skip)
+				return true;
+
+			if (m_depth != 2)
+				return false;
+
+			if (m_field == f_other)
+				return true;
+
+			const char* _begin = _value.data();
+			const char* _end = _begin + _value.size();
+
+			if (m_field == f_time)
+			{
+				long _integer;
+				return parseNumber(_begin, _end, _integer) && number(static_cast<double>(_integer), _integer);
+			}
+
+			double _real;
+			return parseNumber(_begin, _end, _real) && number(_real, 0);
+		}
+
+		bool start_object(std::size_t)
+		{
+			if (m_skip)
+			{
+				++m_skip;
+				return true;
+			}
+
+			// every point is an object placed directly in the top array
+			if (m_depth == 1)
+			{
+				m_fields = 0;
+				m_depth = 2;
+				return true;
+			}
+
+			return m_depth == 2 && m_field == f_other ? skipContainer() : false;
+		}
+
+		bool start_array(std::size_t)
+		{
+			if (m_skip)
+			{
+				++m_skip;
+				return true;
+			}
+
+			// the document must be an array
+			if (m_depth == 0)
+			{
+				m_depth = 1;
+				return true;
+			}
+
+			return m_depth == 2 && m_field == f_other ? skipContainer() : false;
+		}
+
+		bool end_object()
+		{
+			if (m_skip)
+			{
+				--m_skip;
+				return true;
+			}
+
+			// every field is required
+			if (m_fields != f_all)
+				return false;
+
+			m_graph.points.push_back(m_point);
+			m_depth = 1;
+			return true;
+		}
+
+		bool end_array()
+		{
+			if (m_skip)
+			{
+				--m_skip;
+				return true;
+			}
+
+			m_depth = 0;
+			return true;
+		}
+
+		bool key(json::string_t& _key)
+		{
+			if (m_skip)
+				return true;
+
+			if (_key == "time")			m_field = f_time;
+			else if (_key == "open")	m_field = f_open;
+			else if (_key == "high")	m_field = f_high;
+			else if (_key == "low")		m_field = f_low;
+			else if (_key == "close")	m_field = f_close;
+			else if (_key == "vol")		m_field = f_vol;
+			else						m_field = f_other;
+
+			return true;
+		}
+
+	private:
+		enum e_field
+		{
+			f_other		= 0,
+			f_time		= 1 << 0,
+			f_open		= 1 << 1,
+			f_high		= 1 << 2,
+			f_low		= 1 << 3,
+			f_close		= 1 << 4,
+			f_vol		= 1 << 5,
+			f_all		= f_time | f_open | f_high | f_low | f_close | f_vol
+		};
+
+		bool number(double _real, long _integer)
+		{
+			if (m_skip)
+				return true;
+
+			if (m_depth != 2)
+				return false;
+
+			switch (m_field)
+			{
+			case f_time:	m_point.time = _integer;	break;
+			case f_open:	m_point.open = _real;		break;
+			case f_high:	m_point.high = _real;		break;
+			case f_low:		m_point.low = _real;		break;
+			case f_close:	m_point.close = _real;		break;
+			case f_vol:		m_point.vol = _real;		break;
+			default:		return true;
+			}
+
+			m_fields |= m_field;
+			return true;
+		}
+
+		s_graph& m_graph;
+		s_graphPoint m_point;
+		e_field m_field;
+		int m_fields;
+	};
+
+	/**
+		Runs given handler over the body, false on any error
+	*/
+	template <typename Handler>
+	bool parseWith(const char* _data, size_t _size, Handler& _handler)
+	{
+		try
+		{
+			return json::sax_parse(_data, _data + _size, &_handler);
+		}
+		catch (...)
+		{
+			return false;
+		}
+	}
+}
+
+bool parseOrderBook(const char* _data, size_t _size, s_orderBook& _orderBook)
+{
+	OrderBookHandler<s_orderBook> _handler(_orderBook);
+	return parseWith(_data, _size, _handler);
+}
+
+bool parseOrderBook(const char* _data, size_t _size, s_fixedOrderBook& _orderBook)
+{
+	OrderBookHandler<s_fixedOrderBook> _handler(_orderBook);
+	return parseWith(_data, _size, _handler);
+}
+
+bool parseTrades(const char* _data, size_t _size, s_trades& _trades)
+{
+	TradesHandler<s_trades> _handler(_trades);
+	return parseWith(_data, _size, _handler);
+}
+
+bool parseTrades(const char* _data, size_t _size, s_fixedTrades& _trades)
+{
+	TradesHandler<s_fixedTrades> _handler(_trades);
+	return parseWith(_data, _size, _handler);
+}
+
+bool parseGraph(const char* _data, size_t _size, s_graph& _graph)
+{
+	GraphHandler _handler(_graph);
+	return parseWith(_data, _size, _handler);
+}
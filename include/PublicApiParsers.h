@@ -0,0 +1,59 @@
+/*
+	Copyright (c) 2019 Maciej Goncerz <https://github.com/Paurin1>.
+	Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+	PublicApiParsers.h file declares functions that parse public API's
+	responses straight into structures from PublicApiDataStructures.h.
+	They are driven by nlohmann::json's SAX interface, so no intermediate
+	JSON document is built and every value is handled exactly once.
+*/
+
+#ifndef PUBLICAPIPARSERS_H
+#define PUBLICAPIPARSERS_H
+
+#include <cstddef>	// size_t
+
+// Defines structures that are used to store public API's data
+#include "PublicApiDataStructures.h"
+
+/**
+	Parses API's orderbook.json file content
+
+	@param _data beginning of the response body
+	@param _size length of the response body
+	@param _orderBook structure the orders are appended to
+	@return false if the body is not a valid order book
+*/
+bool parseOrderBook(const char* _data, size_t _size, s_orderBook& _orderBook);
+
+/**
+	Parses API's orderbook.json file content, rates and amounts are read exactly from their text
+*/
+bool parseOrderBook(const char* _data, size_t _size, s_fixedOrderBook& _orderBook);
+
+/**
+	Parses API's trades.json file content
+
+	@param _data beginning of the response body
+	@param _size length of the response body
+	@param _trades structure the trades are appended to
+	@return false if the body is not a valid list of trades
+*/
+bool parseTrades(const char* _data, size_t _size, s_trades& _trades);
+
+/**
+	Parses API's trades.json file content, prices and amounts are read exactly from their text
+*/
+bool parseTrades(const char* _data, size_t _size, s_fixedTrades& _trades);
+
+/**
+	Parses json file with graph's data points
+
+	@param _data beginning of the response body
+	@param _size length of the response body
+	@param _graph structure the points are appended to
+	@return false if the body is not a valid list of points
+*/
+bool parseGraph(const char* _data, size_t _size, s_graph& _graph);
+
+#endif
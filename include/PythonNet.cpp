@@ -21,57 +21,53 @@ PythonNet::PythonNet(std::string _pyPath, std::string _pyFile)
 { }
 
 std::string PythonNet::get(std::string _url)
+{
+	return f_execute(_url);
+}
+
+std::string PythonNet::post(std::string _url, std::string _params, std::string _headers)
+{
+	return f_execute(_url + " \"" + _params + "\" \"" + _headers + "\"");
+}
+
+std::string PythonNet::f_execute(const std::string& _arguments)
 {
 	// check whether both required variables are already set
 	if (m_pyPath.empty() || m_pyFile.empty())
 		return std::string();
 
-	// execute python script and catch the its return code
-	int _ret = system((python_path + " " + m_pyPath + "/" + m_pyFile + " " + _url).c_str());
-
-	// if it's equal to ZERO then the python script has finished correctly
-	if (_ret)
-		return std::string();
+	std::string _command = python_path + " " + m_pyPath + "/" + m_pyFile + " " + _arguments;
 
-	// open the file python script outputted
-	std::ifstream _inFileStream("python_json_output");
+	// execute python script with its standard output redirected into a pipe,
+	// unlike a shared file the pipe belongs to this request only
+#ifdef _WIN32
+	FILE* _pipe = _popen(_command.c_str(), "rb");
+#else
+	FILE* _pipe = popen(_command.c_str(), "r");
+#endif
 
-	// check if it's opened correctly
-	if (_inFileStream.is_open() == false)
+	if (!_pipe)
 		return std::string();
 
-	// transfer it's data into _fileData string and close
-	std::string _fileData((std::istreambuf_iterator<char>(_inFileStream)), std::istreambuf_iterator<char>());
-	_inFileStream.close();
+	// transfer data printed by the script into _output string
+	std::string _output;
+	char _buffer[4096];
+	size_t _count;
 
-	// return data generated by python script
-	return _fileData;
-}
+	while ((_count = fread(_buffer, 1, sizeof(_buffer), _pipe)) > 0)
+		_output.append(_buffer, _count);
 
-std::string PythonNet::post(std::string _url, std::string _params, std::string _headers)
-{
-	// check whether both required variables are already set
-	if (m_pyPath.empty() || m_pyFile.empty())
-		return std::string();
-
-	// execute python script and catch the its return code
-	int _ret = system((python_path + " " + m_pyPath + "/" + m_pyFile + " " + _url + " \"" + _params + "\" \"" + _headers + "\"").c_str());
+	// catch the script's return code
+#ifdef _WIN32
+	int _ret = _pclose(_pipe);
+#else
+	int _ret = pclose(_pipe);
+#endif
 
 	// if it's equal to ZERO then the python script has finished correctly
 	if (_ret)
 		return std::string();
 
-	// open the file python script outputted
-	std::ifstream _inFileStream("python_json_output");
-
-	// check if it's opened correctly
-	if (_inFileStream.is_open() == false)
-		return std::string();
-
-	// transfer it's data into _fileData string and close
-	std::string _fileData((std::istreambuf_iterator<char>(_inFileStream)), std::istreambuf_iterator<char>());
-	_inFileStream.close();
-
 	// return data generated by python script
-	return _fileData;
+	return _output;
 }
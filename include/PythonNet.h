@@ -0,0 +1,64 @@
+/*
+	Copyright (c) 2019 Maciej Goncerz <https://github.com/Paurin1>.
+	Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+	PythonNet class executes external python script that sends HTTPS
+	requests to Bitmarket API. The script prints the response to its
+	standard output which is read back through a pipe, so every request
+	has its own output channel and many of them can run in parallel.
+
+	BitmarketPublic and BitmarketPrivate use HttpsNet instead, this class
+	is kept for projects that still rely on the python script.
+*/
+
+#ifndef PYTHONNET_H
+#define PYTHONNET_H
+
+#include <string>	// string
+#include <cstdio>	// FILE, fread, popen, pclose
+
+class PythonNet
+{
+public:
+	PythonNet();
+	PythonNet(std::string _pyPath, std::string _pyFile);
+
+	/**
+		Sends GET request through python script
+
+		@param _url path of the requested resource, i.e. /json/BTCPLN/ticker.json
+		@return body of the response or an empty string if an error has occured
+	*/
+	std::string get(std::string _url);
+
+	/**
+		Sends POST request through python script
+
+		@param _url path of the requested resource, i.e. /api2/
+		@param _params url-encoded body of the request
+		@param _headers additional headers in form of "Name1=value1&Name2=value2"
+		@return body of the response or an empty string if an error has occured
+	*/
+	std::string post(std::string _url, std::string _params, std::string _headers);
+
+	/**
+		Directory where the script file is located
+	*/
+	std::string m_pyPath;
+
+	/**
+		Name of python script file
+	*/
+	std::string m_pyFile;
+
+private:
+	/**
+		Executes python script and captures its standard output
+
+		@param _arguments command line arguments passed to the script
+		@return data printed by the script or an empty string if it has failed
+	*/
+	std::string f_execute(const std::string& _arguments);
+};
+
+#endif
@@ -0,0 +1,80 @@
+/*
+	Copyright (c) 2019 Maciej Goncerz <https://github.com/Paurin1>.
+	Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+	More detailed descriptions are in RateLimiter.h file.
+*/
+
+#include "RateLimiter.h"
+
+#include <algorithm>	// min
+#include <cmath>		// ceil
+
+RateLimiter::RateLimiter(double _rate, double _burst) : m_rate(_rate), m_burst(_burst), m_tokens(_burst), m_refilled(std::chrono::steady_clock::now())
+{ }
+
+bool RateLimiter::tryAcquire(double _tokens)
+{
+	std::lock_guard<std::mutex> _lock(m_mutex);
+	f_refill(std::chrono::steady_clock::now());
+
+	if (m_tokens < _tokens)
+		return false;
+
+	m_tokens -= _tokens;
+	return true;
+}
+
+std::chrono::milliseconds RateLimiter::waitTime(double _tokens)
+{
+	std::lock_guard<std::mutex> _lock(m_mutex);
+	f_refill(std::chrono::steady_clock::now());
+
+	if (m_tokens >= _tokens)
+		return std::chrono::milliseconds(0);
+
+	// a bucket that never refills would make the caller wait forever, an hour is long enough
+	if (m_rate <= 0)
+		return std::chrono::hours(1);
+
+	return std::chrono::milliseconds(static_cast<long long>(std::ceil((_tokens - m_tokens) * 1000 / m_rate)));
+}
+
+double RateLimiter::available()
+{
+	std::lock_guard<std::mutex> _lock(m_mutex);
+	f_refill(std::chrono::steady_clock::now());
+	return m_tokens;
+}
+
+void RateLimiter::configure(double _rate, double _burst)
+{
+	std::lock_guard<std::mutex> _lock(m_mutex);
+
+	// tokens gathered so far are counted with the old rate
+	f_refill(std::chrono::steady_clock::now());
+
+	m_rate = _rate;
+	m_burst = _burst;
+	m_tokens = std::min(m_tokens, m_burst);
+}
+
+double RateLimiter::rate()
+{
+	std::lock_guard<std::mutex> _lock(m_mutex);
+	return m_rate;
+}
+
+double RateLimiter::burst()
+{
+	std::lock_guard<std::mutex> _lock(m_mutex);
+	return m_burst;
+}
+
+void RateLimiter::f_refill(std::chrono::steady_clock::time_point _now)
+{
+	std::chrono::duration<double> _elapsed = _now - m_refilled;
+	m_refilled = _now;
+
+	m_tokens = std::min(m_burst, m_tokens + _elapsed.count() * m_rate);
+}
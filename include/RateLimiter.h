@@ -0,0 +1,71 @@
+/*
+	Copyright (c) 2019 Maciej Goncerz <https://github.com/Paurin1>.
+	Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+	RateLimiter class is a token bucket shared by everything that sends
+	requests to the API. Tokens flow in at a steady rate up to the size of
+	the bucket, every request takes one. Short bursts are allowed while
+	the average stays below the rate, so the API's limits are never hit.
+*/
+
+#ifndef RATELIMITER_H
+#define RATELIMITER_H
+
+#include <mutex>	// mutex, lock_guard
+#include <chrono>	// steady_clock, milliseconds
+
+class RateLimiter
+{
+public:
+	/**
+		@param _rate number of tokens added every second
+		@param _burst maximum number of tokens stored, the bucket starts full
+	*/
+	RateLimiter(double _rate, double _burst);
+
+	RateLimiter(const RateLimiter&) = delete;
+	RateLimiter& operator=(const RateLimiter&) = delete;
+
+	/**
+		Takes tokens from the bucket if there are enough of them, may be called from any thread
+
+		@param _tokens cost of the request
+		@return true if the tokens have been taken
+	*/
+	bool tryAcquire(double _tokens = 1);
+
+	/**
+		Returns time after which tryAcquire() of given number of tokens will succeed
+
+		@param _tokens cost of the request
+		@return zero if the tokens are available now
+	*/
+	std::chrono::milliseconds waitTime(double _tokens = 1);
+
+	/**
+		Returns number of tokens currently in the bucket
+	*/
+	double available();
+
+	/**
+		Changes refill rate and size of the bucket, stored tokens are kept up to the new size
+	*/
+	void configure(double _rate, double _burst);
+
+	double rate();
+	double burst();
+
+private:
+	/**
+		Adds tokens that have flowed in since the last refill
+	*/
+	void f_refill(std::chrono::steady_clock::time_point _now);
+
+	double m_rate;
+	double m_burst;
+	double m_tokens;
+	std::chrono::steady_clock::time_point m_refilled;
+	std::mutex m_mutex;
+};
+
+#endif
@@ -0,0 +1,137 @@
+/*
+	Copyright (c) 2019 Maciej Goncerz <https://github.com/Paurin1>.
+	Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+	More detailed descriptions are in ResponseBuffer.h file.
+*/
+
+#include "ResponseBuffer.h"
+
+#include <cstring>	// memcpy
+#include <atomic>	// atomic_thread_fence
+
+// initial size of a buffer, enough for a ticker or a small order book
+const size_t response_buffer_initial_size = 16384;
+
+ResponseBuffer::ResponseBuffer() : m_capacity(0), m_filled(0), m_begin(0), m_end(0)
+{ }
+
+const char* ResponseBuffer::data() const
+{
+	return m_storage.get() + m_begin;
+}
+
+size_t ResponseBuffer::size() const
+{
+	return m_end - m_begin;
+}
+
+bool ResponseBuffer::empty() const
+{
+	return m_end == m_begin;
+}
+
+std::string ResponseBuffer::str() const
+{
+	return std::string(data(), size());
+}
+
+void ResponseBuffer::clear()
+{
+	m_filled = m_begin = m_end = 0;
+}
+
+size_t ResponseBuffer::capacity() const
+{
+	return m_capacity;
+}
+
+char* ResponseBuffer::prepare(size_t _count)
+{
+	if (m_capacity - m_filled < _count)
+	{
+		// grow geometrically so that big bodies don't reallocate on every read
+		size_t _capacity = m_capacity ? m_capacity : response_buffer_initial_size;
+
+		while (_capacity - m_filled < _count)
+			_capacity *= 2;
+
+		std::unique_ptr<char[]> _storage(new char[_capacity]);
+
+		if (m_filled)
+			memcpy(_storage.get(), m_storage.get(), m_filled);
+
+		m_storage.swap(_storage);
+		m_capacity = _capacity;
+	}
+
+	return m_storage.get() + m_filled;
+}
+
+size_t ResponseBuffer::writable() const
+{
+	return m_capacity - m_filled;
+}
+
+void ResponseBuffer::commit(size_t _count)
+{
+	m_filled += _count;
+}
+
+char* ResponseBuffer::raw()
+{
+	return m_storage.get();
+}
+
+size_t ResponseBuffer::filled() const
+{
+	return m_filled;
+}
+
+void ResponseBuffer::view(size_t _begin, size_t _end)
+{
+	m_begin = _begin;
+	m_end = _end;
+}
+
+ResponseBufferPool::ResponseBufferPool(size_t _maxBuffers) : m_maxBuffers(_maxBuffers)
+{ }
+
+std::shared_ptr<ResponseBufferPool> ResponseBufferPool::shared()
+{
+	static std::shared_ptr<ResponseBufferPool> _shared = std::make_shared<ResponseBufferPool>();
+	return _shared;
+}
+
+std::shared_ptr<ResponseBuffer> ResponseBufferPool::acquire()
+{
+	std::lock_guard<std::mutex> _lock(m_mutex);
+
+	// a buffer referenced only by the pool has been released by its last user,
+	// handing out a copy of the pointer doesn't allocate anything
+	for (auto& _buffer : m_buffers)
+	{
+		if (_buffer.use_count() == 1)
+		{
+			// make previous owner's writes visible before the buffer is reused
+			std::atomic_thread_fence(std::memory_order_acquire);
+
+			_buffer->clear();
+			return _buffer;
+		}
+	}
+
+	std::shared_ptr<ResponseBuffer> _buffer = std::make_shared<ResponseBuffer>();
+
+	// when every pooled buffer is in use, extra ones live only as long as their users
+	if (m_buffers.size() < m_maxBuffers)
+		m_buffers.push_back(_buffer);
+
+	return _buffer;
+}
+
+size_t ResponseBufferPool::size()
+{
+	std::lock_guard<std::mutex> _lock(m_mutex);
+	return m_buffers.size();
+}
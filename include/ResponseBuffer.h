@@ -0,0 +1,142 @@
+/*
+	Copyright (c) 2019 Maciej Goncerz <https://github.com/Paurin1>.
+	Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+	ResponseBuffer class is a contiguous block of memory the transport
+	reads a response into. The body is decoded in place and exposed as a
+	view over that memory, so parsers consume the very bytes that came
+	from the connection.
+
+	ResponseBufferPool hands out buffers as shared pointers and takes them
+	back once the last owner releases them. The memory is kept, therefore
+	after a few requests polling doesn't allocate anything for the body.
+*/
+
+#ifndef RESPONSEBUFFER_H
+#define RESPONSEBUFFER_H
+
+#include <string>	// string
+#include <memory>	// unique_ptr, shared_ptr
+#include <vector>	// vector
+#include <mutex>	// mutex, lock_guard
+
+class ResponseBuffer
+{
+public:
+	ResponseBuffer();
+
+	ResponseBuffer(const ResponseBuffer&) = delete;
+	ResponseBuffer& operator=(const ResponseBuffer&) = delete;
+
+	/**
+		Returns beginning of the response body
+	*/
+	const char* data() const;
+
+	/**
+		Returns length of the response body
+	*/
+	size_t size() const;
+
+	/**
+		Returns true when the body is empty
+	*/
+	bool empty() const;
+
+	/**
+		Returns copy of the body, for code that needs std::string
+	*/
+	std::string str() const;
+
+	/**
+		Forgets the content but keeps allocated memory
+	*/
+	void clear();
+
+	/**
+		Returns number of bytes the buffer can hold without reallocation
+	*/
+	size_t capacity() const;
+
+	/*
+		Methods below are used by the transport to fill the buffer
+	*/
+
+	/**
+		Makes sure at least _count bytes can be written after the filled part
+
+		@return pointer to the first writable byte
+	*/
+	char* prepare(size_t _count);
+
+	/**
+		Returns number of bytes that can be written without reallocation
+	*/
+	size_t writable() const;
+
+	/**
+		Marks _count bytes written after the filled part as filled
+	*/
+	void commit(size_t _count);
+
+	/**
+		Returns beginning of the filled part, headers included
+	*/
+	char* raw();
+
+	/**
+		Returns length of the filled part
+	*/
+	size_t filled() const;
+
+	/**
+		Sets which part of the filled memory is the body
+
+		@param _begin offset of the first byte of the body
+		@param _end offset past the last byte of the body
+	*/
+	void view(size_t _begin, size_t _end);
+
+private:
+	std::unique_ptr<char[]> m_storage;
+	size_t m_capacity;
+	size_t m_filled;
+	size_t m_begin;
+	size_t m_end;
+};
+
+class ResponseBufferPool
+{
+public:
+	/**
+		@param _maxBuffers maximum number of buffers kept for reuse
+	*/
+	ResponseBufferPool(size_t _maxBuffers = 32);
+
+	ResponseBufferPool(const ResponseBufferPool&) = delete;
+	ResponseBufferPool& operator=(const ResponseBufferPool&) = delete;
+
+	/**
+		Returns the pool shared by default by every HttpsNet object
+	*/
+	static std::shared_ptr<ResponseBufferPool> shared();
+
+	/**
+		Hands out an empty buffer, reuses one no longer referenced by anyone if possible
+
+		@return buffer owned by the caller for as long as it keeps the pointer
+	*/
+	std::shared_ptr<ResponseBuffer> acquire();
+
+	/**
+		Returns number of buffers owned by the pool, both free and in use
+	*/
+	size_t size();
+
+private:
+	std::vector<std::shared_ptr<ResponseBuffer>> m_buffers;
+	size_t m_maxBuffers;
+	std::mutex m_mutex;
+};
+
+#endif
@@ -0,0 +1,207 @@
+/*
+	Copyright (c) 2019 Maciej Goncerz <https://github.com/Paurin1>.
+	Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+	More detailed descriptions are in ResponseCache.h file.
+*/
+
+#include "ResponseCache.h"
+
+ResponseCache::ResponseCache(std::shared_ptr<IoExecutor> _executor, size_t _capacity) :
+	m_executor(_executor ? _executor : IoExecutor::shared()), m_capacity(_capacity),
+	m_default{ "", std::chrono::milliseconds(0), std::chrono::milliseconds(0) }, m_statistics{ 0, 0, 0, 0, 0 }
+{
+	// data changing every moment is kept for a second, graphs as long as their points last
+	ttl("/ticker.json", std::chrono::seconds(1));
+	ttl("/orderbook.json", std::chrono::seconds(1));
+	ttl("/trades.json", std::chrono::seconds(1));
+	ttl("/graphs/", std::chrono::minutes(1));
+	ttl("/7d.json", std::chrono::minutes(15));
+	ttl("/1m.json", std::chrono::hours(1));
+	ttl("/3m.json", std::chrono::hours(1));
+	ttl("/6m.json", std::chrono::hours(1));
+	ttl("/1y.json", std::chrono::hours(1));
+}
+
+void ResponseCache::ttl(std::string _pattern, std::chrono::milliseconds _ttl, std::chrono::milliseconds _stale)
+{
+	std::lock_guard<std::mutex> _lock(m_mutex);
+
+	for (s_rule& _rule : m_rules)
+	{
+		if (_rule.pattern == _pattern)
+		{
+			_rule.ttl = _ttl;
+			_rule.stale = _stale;
+			return;
+		}
+	}
+
+	m_rules.push_back({ std::move(_pattern), _ttl, _stale });
+}
+
+void ResponseCache::clear()
+{
+	std::lock_guard<std::mutex> _lock(m_mutex);
+
+	m_entries.clear();
+}
+
+size_t ResponseCache::size()
+{
+	std::lock_guard<std::mutex> _lock(m_mutex);
+
+	return m_entries.size();
+}
+
+ResponseCache::s_statistics ResponseCache::statistics()
+{
+	std::lock_guard<std::mutex> _lock(m_mutex);
+
+	return m_statistics;
+}
+
+std::shared_ptr<const void> ResponseCache::f_get(const std::string& _url, std::type_index _type, fetch_function _fetch)
+{
+	entry_key _key(_url, _type);
+
+	{
+		std::lock_guard<std::mutex> _lock(m_mutex);
+
+		auto _found = m_entries.find(_key);
+		std::chrono::steady_clock::time_point _now = std::chrono::steady_clock::now();
+
+		if (_found != m_entries.end() && _now < _found->second.fresh)
+		{
+			++m_statistics.hits;
+			return _found->second.value;
+		}
+
+		// a stale entry is returned at once, a fresh one is requested in the background
+		if (_found != m_entries.end() && _now < _found->second.stale)
+		{
+			++m_statistics.staleHits;
+
+			if (!_found->second.refreshing)
+			{
+				_found->second.refreshing = true;
+				m_executor->post([this, _key, _fetch]() { f_refresh(_key, _fetch); });
+			}
+
+			return _found->second.value;
+		}
+	}
+
+	// callers missing the entry at once share one request
+	bool _joined = false;
+	std::shared_ptr<const void> _value = m_flights.run(_key, [this, &_key, &_fetch]() { return f_fetch(_key, _fetch); }, &_joined);
+
+	std::lock_guard<std::mutex> _lock(m_mutex);
+
+	if (_joined)
+		++m_statistics.coalesced;
+	else
+		++m_statistics.misses;
+
+	return _value;
+}
+
+std::shared_ptr<const void> ResponseCache::f_fetch(const entry_key& _key, const fetch_function& _fetch)
+{
+	std::shared_ptr<const void> _value;
+	HttpsNet::s_validators _validators = { std::string(), std::string(), false };
+
+	{
+		std::lock_guard<std::mutex> _lock(m_mutex);
+
+		// an entry past its stale time is still worth revalidating until it's trimmed
+		auto _found = m_entries.find(_key);
+		if (_found != m_entries.end())
+			_validators = _found->second.validators;
+	}
+
+	_validators.notModified = false;
+
+	try
+	{
+		_value = _fetch(_validators);
+	}
+	catch (...)
+	{
+		_value = nullptr;
+		_validators.notModified = false;
+	}
+
+	std::lock_guard<std::mutex> _lock(m_mutex);
+	std::chrono::steady_clock::time_point _now = std::chrono::steady_clock::now();
+	auto _found = m_entries.find(_key);
+
+	// the server has confirmed the entry, unless it has been cleared in the meantime
+	if (!_value && _validators.notModified && _found != m_entries.end())
+	{
+		_value = _found->second.value;
+		++m_statistics.revalidated;
+	}
+
+	if (_value)
+	{
+		const s_rule& _rule = f_rule(_key.first);
+		m_entries[_key] = { _value, _now + _rule.ttl, _now + _rule.ttl + _rule.stale, false, _validators };
+
+		f_trim(_now);
+	}
+	else if (_found != m_entries.end())
+	{
+		// a failed refresh leaves the stale value for the rest of its time
+		_found->second.refreshing = false;
+	}
+
+	return _value;
+}
+
+void ResponseCache::f_refresh(const entry_key& _key, const fetch_function& _fetch)
+{
+	{
+		std::lock_guard<std::mutex> _lock(m_mutex);
+
+		// a caller that found the entry expired before this task ran has already refreshed it
+		auto _found = m_entries.find(_key);
+		if (_found == m_entries.end())
+			return;
+
+		if (std::chrono::steady_clock::now() < _found->second.fresh)
+		{
+			_found->second.refreshing = false;
+			return;
+		}
+	}
+
+	m_flights.run(_key, [this, &_key, &_fetch]() { return f_fetch(_key, _fetch); });
+}
+
+const ResponseCache::s_rule& ResponseCache::f_rule(const std::string& _url) const
+{
+	const s_rule* _best = &m_default;
+
+	for (const s_rule& _rule : m_rules)
+	{
+		if (_rule.pattern.size() >= _best->pattern.size() && _url.find(_rule.pattern) != std::string::npos)
+			_best = &_rule;
+	}
+
+	return *_best;
+}
+
+void ResponseCache::f_trim(std::chrono::steady_clock::time_point _now)
+{
+	if (m_entries.size() <= m_capacity)
+		return;
+
+	for (auto _entry = m_entries.begin(); _entry != m_entries.end();)
+	{
+		if (!_entry->second.refreshing && _now >= _entry->second.stale)
+			_entry = m_entries.erase(_entry);
+		else
+			++_entry;
+	}
+}
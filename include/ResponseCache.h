@@ -0,0 +1,183 @@
+/*
+	Copyright (c) 2019 Maciej Goncerz <https://github.com/Paurin1>.
+	Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+	ResponseCache class keeps parsed responses of public endpoints for a
+	while, keyed by host with URL and type of the result. How long depends
+	on the endpoint: the longest pattern found in the URL decides, i.e.
+	ticker is kept for a second and yearly graph for an hour by default.
+
+	Callers missing the same entry at once share one request through
+	SingleFlight: the first one sends it, the others wait for its result.
+	An entry may also be given a stale period, after its time to live it's
+	still returned at once while a fresh one is requested in the background.
+
+	Entries keep validators (ETag, Last-Modified) of the response they come
+	from. When an entry expires, they are passed to the request, so that it
+	may be conditional; if the server answers 304 Not Modified, the entry is
+	kept for another time to live without sending and parsing the body again.
+
+	Results are shared by every caller, so they are pointers to const. Failed
+	requests (nullptr) are not cached. The cache is thread safe and may be
+	shared by many BitmarketPublic objects, see BitmarketPublic::cache().
+*/
+
+#ifndef RESPONSECACHE_H
+#define RESPONSECACHE_H
+
+#include <cstddef>		// size_t
+#include <string>		// string
+#include <vector>		// vector
+#include <map>			// map
+#include <memory>		// shared_ptr, static_pointer_cast
+#include <mutex>		// mutex, unique_lock
+#include <functional>	// function
+#include <typeindex>	// type_index
+#include <typeinfo>		// typeid
+#include <utility>		// pair
+#include <chrono>		// steady_clock, milliseconds
+
+// Thread pool running background requests
+#include "IoExecutor.h"
+
+// Shares requests of callers missing the same entry
+#include "SingleFlight.h"
+
+// Validators of conditional requests
+#include "HttpsNet.h"
+
+class ResponseCache
+{
+public:
+	/**
+		Counters of cache lookups
+	*/
+	struct s_statistics
+	{
+		unsigned long hits;			// fresh entry returned
+		unsigned long staleHits;	// stale entry returned, refreshed in the background
+		unsigned long misses;		// request sent by the caller
+		unsigned long coalesced;	// waited for a request sent by another caller
+		unsigned long revalidated;	// server confirmed an expired entry hasn't changed
+	};
+
+	/**
+		The cache must outlive background refreshes it has started
+
+		@param _executor threads running background refreshes, IoExecutor::shared() by default
+		@param _capacity number of entries above which expired ones are dropped
+	*/
+	ResponseCache(std::shared_ptr<IoExecutor> _executor = nullptr, size_t _capacity = 4096);
+
+	ResponseCache(const ResponseCache&) = delete;
+	ResponseCache& operator=(const ResponseCache&) = delete;
+
+	/**
+		Sets how long responses of URLs containing given pattern are kept, zero time to live only shares requests in flight
+
+		@param _pattern part of the URL, i.e. "/ticker.json" or "/1y.json"
+		@param _ttl time a response is returned as fresh
+		@param _stale time after that a response is still returned while a fresh one is requested
+	*/
+	void ttl(std::string _pattern, std::chrono::milliseconds _ttl, std::chrono::milliseconds _stale = std::chrono::milliseconds(0));
+
+	/**
+		Returns cached result of the URL or the result of _fetch, which is called by one caller at a time
+
+		@param _url key of the entry
+		@param _fetch function sending the request, nullptr on error; it's kept for a background
+					refresh of a stale entry, so it must own everything it uses rather than
+					refer to the caller, which may be gone by then
+	*/
+	template <typename T>
+	std::shared_ptr<const T> get(const std::string& _url, std::function<std::shared_ptr<T>()> _fetch)
+	{
+		return std::static_pointer_cast<const T>(f_get(_url, std::type_index(typeid(T)),
+			[_fetch](HttpsNet::s_validators&) -> std::shared_ptr<void> { return _fetch(); }));
+	}
+
+	/**
+		Like the above, but _fetch may send a conditional request
+
+		@param _fetch gets validators of the expired entry (empty if there's none) and replaces
+					them with those of the response; it returns nullptr and sets notModified
+					when the server answers 304, then the entry is kept
+	*/
+	template <typename T>
+	std::shared_ptr<const T> get(const std::string& _url, std::function<std::shared_ptr<T>(HttpsNet::s_validators&)> _fetch)
+	{
+		return std::static_pointer_cast<const T>(f_get(_url, std::type_index(typeid(T)),
+			[_fetch](HttpsNet::s_validators& _validators) -> std::shared_ptr<void> { return _fetch(_validators); }));
+	}
+
+	/**
+		Drops every entry, requests in flight still deliver to their callers
+	*/
+	void clear();
+
+	/**
+		Returns number of entries
+	*/
+	size_t size();
+
+	/**
+		Returns copy of lookup counters
+	*/
+	s_statistics statistics();
+
+private:
+	typedef std::function<std::shared_ptr<void>(HttpsNet::s_validators&)> fetch_function;
+	typedef std::pair<std::string, std::type_index> entry_key;
+
+	struct s_entry
+	{
+		std::shared_ptr<const void> value;
+		std::chrono::steady_clock::time_point fresh;	// returned as fresh until then
+		std::chrono::steady_clock::time_point stale;	// returned as stale until then
+		bool refreshing;								// background refresh has been queued
+		HttpsNet::s_validators validators;				// of the response the value comes from
+	};
+
+	struct s_rule
+	{
+		std::string pattern;
+		std::chrono::milliseconds ttl;
+		std::chrono::milliseconds stale;
+	};
+
+	std::shared_ptr<const void> f_get(const std::string& _url, std::type_index _type, fetch_function _fetch);
+
+	/**
+		Sends the request and stores its result, run by one caller of the entry at a time
+	*/
+	std::shared_ptr<const void> f_fetch(const entry_key& _key, const fetch_function& _fetch);
+
+	/**
+		Background refresh of a stale entry, skipped if a caller has refreshed it in the meantime
+	*/
+	void f_refresh(const entry_key& _key, const fetch_function& _fetch);
+
+	/**
+		Returns rule with the longest pattern found in the URL, m_mutex must be locked
+	*/
+	const s_rule& f_rule(const std::string& _url) const;
+
+	/**
+		Drops entries past their stale time when there are too many, m_mutex must be locked
+	*/
+	void f_trim(std::chrono::steady_clock::time_point _now);
+
+	std::shared_ptr<IoExecutor> m_executor;
+	size_t m_capacity;
+
+	std::vector<s_rule> m_rules;
+	s_rule m_default;
+	std::map<entry_key, s_entry> m_entries;
+	s_statistics m_statistics;
+
+	SingleFlight<entry_key, void> m_flights;
+
+	std::mutex m_mutex;
+};
+
+#endif
@@ -0,0 +1,133 @@
+/*
+	Copyright (c) 2019 Maciej Goncerz <https://github.com/Paurin1>.
+	Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+	SingleFlight class lets callers asking for the same thing at once share
+	one request. The first caller of a key runs the request, callers of
+	the same key arriving before it's done wait for it and get the same
+	result, as a pointer to const since every one of them holds it. Nothing
+	is kept afterwards, the next caller runs a new request.
+
+	BitmarketPublic sends public requests through one SingleFlight shared
+	by every object in the process, keyed by host and URL, so a burst of
+	identical requests from many threads reaches the API once.
+*/
+
+#ifndef SINGLEFLIGHT_H
+#define SINGLEFLIGHT_H
+
+#include <cstddef>		// size_t
+#include <map>			// map
+#include <memory>		// shared_ptr, make_shared
+#include <mutex>		// mutex, unique_lock
+#include <future>		// promise, shared_future
+#include <functional>	// function
+
+template <typename Key, typename T>
+class SingleFlight
+{
+public:
+	typedef std::shared_ptr<const T> result_type;
+	typedef std::function<result_type()> fetch_function;
+
+	SingleFlight() : m_led(0), m_joined(0) { }
+
+	SingleFlight(const SingleFlight&) = delete;
+	SingleFlight& operator=(const SingleFlight&) = delete;
+
+	/**
+		Returns instance shared by every user of the same Key and T
+	*/
+	static std::shared_ptr<SingleFlight> shared()
+	{
+		static std::shared_ptr<SingleFlight> _shared = std::make_shared<SingleFlight>();
+		return _shared;
+	}
+
+	/**
+		Runs _fetch, or waits for the call of the same key already running and returns its result
+
+		@param _fetch request, an exception it throws is returned as nullptr to every caller
+		@param _joined set to whether the result comes from another caller's request
+	*/
+	result_type run(const Key& _key, const fetch_function& _fetch, bool* _joined = nullptr)
+	{
+		std::unique_lock<std::mutex> _lock(m_mutex);
+
+		auto _found = m_calls.find(_key);
+		if (_found != m_calls.end())
+		{
+			std::shared_future<result_type> _future = _found->second;
+			++m_joined;
+			_lock.unlock();
+
+			if (_joined)
+				*_joined = true;
+
+			return _future.get();
+		}
+
+		std::promise<result_type> _promise;
+		m_calls.emplace(_key, _promise.get_future().share());
+		++m_led;
+		_lock.unlock();
+
+		if (_joined)
+			*_joined = false;
+
+		result_type _result;
+
+		try
+		{
+			_result = _fetch();
+		}
+		catch (...)
+		{
+			_result = nullptr;
+		}
+
+		// callers coming from now on start a new request
+		_lock.lock();
+		m_calls.erase(_key);
+		_lock.unlock();
+
+		_promise.set_value(_result);
+
+		return _result;
+	}
+
+	/**
+		Returns number of requests running
+	*/
+	size_t inFlight()
+	{
+		std::lock_guard<std::mutex> _lock(m_mutex);
+		return m_calls.size();
+	}
+
+	/**
+		Returns number of requests run
+	*/
+	unsigned long led()
+	{
+		std::lock_guard<std::mutex> _lock(m_mutex);
+		return m_led;
+	}
+
+	/**
+		Returns number of callers that got the result of another caller's request
+	*/
+	unsigned long joined()
+	{
+		std::lock_guard<std::mutex> _lock(m_mutex);
+		return m_joined;
+	}
+
+private:
+	std::map<Key, std::shared_future<result_type>> m_calls;
+	unsigned long m_led;
+	unsigned long m_joined;
+	std::mutex m_mutex;
+};
+
+#endif
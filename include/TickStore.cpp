@@ -0,0 +1,388 @@
+/*
+	Copyright (c) 2019 Maciej Goncerz <https://github.com/Paurin1>.
+	Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+	More detailed descriptions are in TickStore.h file.
+*/
+
+#include "TickStore.h"
+
+#include <algorithm>	// sort, lower_bound, upper_bound
+#include <atomic>		// atomic_signal_fence
+#include <cstdio>		// snprintf
+#include <cstring>		// memcpy, memcmp
+
+namespace
+{
+	// first 64 bytes of every segment, columns follow it
+	struct s_segmentHeader
+	{
+		char magic[8];
+		std::uint32_t kind;
+		std::uint32_t columns;
+		std::uint64_t capacity;
+		std::uint64_t count;
+		char reserved[32];
+	};
+
+	static_assert(sizeof(s_segmentHeader) == 64, "segment header must keep columns aligned to 64 bytes");
+
+	const char segment_magic[8] = { 'B', 'M', 'T', 'I', 'C', 'K', 'S', '1' };
+
+	// width of every column in bytes: tid, date, price, amount, type of trades and time, open, high, low, close, vol of points
+	const size_t trade_widths[] = { 8, 8, 8, 8, 1 };
+	const size_t point_widths[] = { 8, 8, 8, 8, 8, 8 };
+
+	const size_t* column_widths(size_t _kind, size_t& _columns)
+	{
+		_columns = _kind == 0 ? sizeof(trade_widths) / sizeof(size_t) : sizeof(point_widths) / sizeof(size_t);
+
+		return _kind == 0 ? trade_widths : point_widths;
+	}
+
+	template <typename T>
+	void put(char* _column, size_t _index, T _value)
+	{
+		std::memcpy(_column + _index * sizeof(T), &_value, sizeof(T));
+	}
+
+	std::uint8_t trade_type(const std::string& _type)
+	{
+		return _type == "buy" ? 0 : _type == "sell" ? 1 : 2;
+	}
+}
+
+constexpr size_t TickStore::segment_rows;
+
+s_trade TickStore::s_tradeSpan::trade(size_t _index) const
+{
+	static const char* const _types[] = { "buy", "sell", "" };
+
+	return { amount[_index], price[_index], static_cast<long>(date[_index]), static_cast<long>(tid[_index]), _types[type[_index] < 2 ? type[_index] : 2] };
+}
+
+s_graphPoint TickStore::s_pointSpan::point(size_t _index) const
+{
+	return { static_cast<long>(time[_index]), open[_index], high[_index], low[_index], close[_index], vol[_index] };
+}
+
+TickStore::TickStore(std::string _directory) :
+	m_directory(std::move(_directory))
+{ }
+
+size_t TickStore::append(const std::string& _market, const std::vector<s_trade>& _trades)
+{
+	s_series& _series = f_series("trades-" + _market, e_trades);
+
+	// pages come newest first, the store takes them in order of tid
+	std::vector<const s_trade*> _sorted;
+	_sorted.reserve(_trades.size());
+
+	for (const s_trade& _trade : _trades)
+		_sorted.push_back(&_trade);
+
+	std::sort(_sorted.begin(), _sorted.end(), [](const s_trade* _a, const s_trade* _b) { return _a->tid < _b->tid; });
+
+	std::int64_t _last = f_lastKey(_series);
+	size_t _stored = 0;
+	size_t i = 0;
+
+	while (i < _sorted.size())
+	{
+		// rows stored already are skipped first, so no segment is created just for them
+		while (i < _sorted.size() && _sorted[i]->tid <= _last)
+			++i;
+
+		if (i == _sorted.size())
+			break;
+
+		s_segment* _segment = f_writable(_series);
+		if (!_segment)
+			break;
+
+		std::uint64_t _count = *_segment->count;
+
+		for (; i < _sorted.size() && _count < segment_rows; ++i)
+		{
+			const s_trade& _trade = *_sorted[i];
+
+			if (_trade.tid <= _last)
+				continue;
+
+			put<std::int64_t>(_segment->columns[0], _count, _trade.tid);
+			put<std::int64_t>(_segment->columns[1], _count, _trade.date);
+			put<double>(_segment->columns[2], _count, _trade.price);
+			put<double>(_segment->columns[3], _count, _trade.amount);
+			put<std::uint8_t>(_segment->columns[4], _count, trade_type(_trade.type));
+
+			_last = _trade.tid;
+			++_count;
+			++_stored;
+		}
+
+		// rows are counted only after they have been written
+		std::atomic_signal_fence(std::memory_order_release);
+		*_segment->count = _count;
+	}
+
+	return _stored;
+}
+
+size_t TickStore::append(const std::string& _market, const std::string& _interval, const CandleColumns& _points)
+{
+	s_series& _series = f_series("graph-" + _market + "-" + _interval, e_points);
+
+	std::vector<size_t> _order(_points.size());
+	for (size_t i = 0; i < _order.size(); ++i)
+		_order[i] = i;
+
+	std::sort(_order.begin(), _order.end(), [&_points](size_t _a, size_t _b) { return _points.time()[_a] < _points.time()[_b]; });
+
+	std::int64_t _last = f_lastKey(_series);
+	size_t _stored = 0;
+	size_t i = 0;
+
+	while (i < _order.size())
+	{
+		while (i < _order.size() && _points.time()[_order[i]] <= _last)
+			++i;
+
+		if (i == _order.size())
+			break;
+
+		s_segment* _segment = f_writable(_series);
+		if (!_segment)
+			break;
+
+		std::uint64_t _count = *_segment->count;
+
+		for (; i < _order.size() && _count < segment_rows; ++i)
+		{
+			CandleColumns::s_constPointRef _point = _points[_order[i]];
+
+			if (_point.time <= _last)
+				continue;
+
+			put<std::int64_t>(_segment->columns[0], _count, _point.time);
+			put<double>(_segment->columns[1], _count, _point.open);
+			put<double>(_segment->columns[2], _count, _point.high);
+			put<double>(_segment->columns[3], _count, _point.low);
+			put<double>(_segment->columns[4], _count, _point.close);
+			put<double>(_segment->columns[5], _count, _point.vol);
+
+			_last = _point.time;
+			++_count;
+			++_stored;
+		}
+
+		// rows are counted only after they have been written
+		std::atomic_signal_fence(std::memory_order_release);
+		*_segment->count = _count;
+	}
+
+	return _stored;
+}
+
+size_t TickStore::append(const s_graph& _graph)
+{
+	return append(_graph.m_market, _graph.m_interval, _graph.points);
+}
+
+void TickStore::scanTrades(const std::string& _market, long _from, long _to, const trade_scanner& _scanner)
+{
+	f_range(f_series("trades-" + _market, e_trades), 0, _from, _to, [&_scanner](const s_segment& _segment, size_t _begin, size_t _end)
+	{
+		_scanner({ reinterpret_cast<const std::int64_t*>(_segment.columns[0]) + _begin, reinterpret_cast<const std::int64_t*>(_segment.columns[1]) + _begin,
+			reinterpret_cast<const double*>(_segment.columns[2]) + _begin, reinterpret_cast<const double*>(_segment.columns[3]) + _begin,
+			reinterpret_cast<const std::uint8_t*>(_segment.columns[4]) + _begin, _end - _begin });
+	});
+}
+
+void TickStore::scanTradesByTime(const std::string& _market, long _from, long _to, const trade_scanner& _scanner)
+{
+	f_range(f_series("trades-" + _market, e_trades), 1, _from, _to, [&_scanner](const s_segment& _segment, size_t _begin, size_t _end)
+	{
+		_scanner({ reinterpret_cast<const std::int64_t*>(_segment.columns[0]) + _begin, reinterpret_cast<const std::int64_t*>(_segment.columns[1]) + _begin,
+			reinterpret_cast<const double*>(_segment.columns[2]) + _begin, reinterpret_cast<const double*>(_segment.columns[3]) + _begin,
+			reinterpret_cast<const std::uint8_t*>(_segment.columns[4]) + _begin, _end - _begin });
+	});
+}
+
+void TickStore::scanPoints(const std::string& _market, const std::string& _interval, long _from, long _to, const point_scanner& _scanner)
+{
+	f_range(f_series("graph-" + _market + "-" + _interval, e_points), 0, _from, _to, [&_scanner](const s_segment& _segment, size_t _begin, size_t _end)
+	{
+		_scanner({ reinterpret_cast<const std::int64_t*>(_segment.columns[0]) + _begin, reinterpret_cast<const double*>(_segment.columns[1]) + _begin,
+			reinterpret_cast<const double*>(_segment.columns[2]) + _begin, reinterpret_cast<const double*>(_segment.columns[3]) + _begin,
+			reinterpret_cast<const double*>(_segment.columns[4]) + _begin, reinterpret_cast<const double*>(_segment.columns[5]) + _begin, _end - _begin });
+	});
+}
+
+std::vector<s_trade> TickStore::trades(const std::string& _market, long _from, long _to)
+{
+	std::vector<s_trade> _trades;
+
+	scanTrades(_market, _from, _to, [&_trades](const s_tradeSpan& _span)
+	{
+		for (size_t i = 0; i < _span.count; ++i)
+			_trades.push_back(_span.trade(i));
+	});
+
+	return _trades;
+}
+
+void TickStore::points(const std::string& _market, const std::string& _interval, CandleColumns& _result, long _from, long _to)
+{
+	scanPoints(_market, _interval, _from, _to, [&_result](const s_pointSpan& _span)
+	{
+		_result.reserve(_result.size() + _span.count);
+
+		for (size_t i = 0; i < _span.count; ++i)
+			_result.push_back(_span.point(i));
+	});
+}
+
+long TickStore::lastTid(const std::string& _market)
+{
+	std::int64_t _last = f_lastKey(f_series("trades-" + _market, e_trades));
+
+	// the series is empty, segments left empty after full ones are skipped by f_lastKey
+	return _last == std::numeric_limits<std::int64_t>::min() ? -1 : static_cast<long>(_last);
+}
+
+long TickStore::lastTime(const std::string& _market, const std::string& _interval)
+{
+	std::int64_t _last = f_lastKey(f_series("graph-" + _market + "-" + _interval, e_points));
+
+	return _last == std::numeric_limits<std::int64_t>::min() ? -1 : static_cast<long>(_last);
+}
+
+bool TickStore::flush()
+{
+	bool _success = true;
+
+	for (auto& _series : m_series)
+	{
+		for (s_segment& _segment : _series.second.segments)
+			_success = _segment.file.flush() && _success;
+	}
+
+	return _success;
+}
+
+TickStore::s_series& TickStore::f_series(const std::string& _name, e_kind _kind)
+{
+	auto _found = m_series.find(_name);
+	if (_found != m_series.end())
+		return _found->second;
+
+	s_series& _series = m_series[_name];
+	_series.kind = _kind;
+	_series.name = _name;
+
+	// segments are numbered from zero, the first missing one ends the series
+	while (f_open(_series, _series.segments.size(), false))
+	{ }
+
+	return _series;
+}
+
+bool TickStore::f_open(s_series& _series, size_t _number, bool _create)
+{
+	char _suffix[24];
+	std::snprintf(_suffix, sizeof(_suffix), ".%06u.seg", static_cast<unsigned>(_number));
+
+	size_t _columns;
+	const size_t* _widths = column_widths(_series.kind, _columns);
+
+	size_t _size = sizeof(s_segmentHeader);
+	for (size_t i = 0; i < _columns; ++i)
+		_size += _widths[i] * segment_rows;
+
+	s_segment _segment;
+	if (!_segment.file.open(m_directory + "/" + _series.name + _suffix, _size, _create))
+		return false;
+
+	s_segmentHeader* _header = reinterpret_cast<s_segmentHeader*>(_segment.file.data());
+
+	// a new file reads as zeros, it gets its header now
+	if (_create && std::memcmp(_header->magic, segment_magic, sizeof(segment_magic)) != 0)
+	{
+		std::memcpy(_header->magic, segment_magic, sizeof(segment_magic));
+		_header->kind = _series.kind;
+		_header->columns = static_cast<std::uint32_t>(_columns);
+		_header->capacity = segment_rows;
+		_header->count = 0;
+	}
+
+	if (std::memcmp(_header->magic, segment_magic, sizeof(segment_magic)) != 0 || _header->kind != static_cast<std::uint32_t>(_series.kind)
+		|| _header->columns != _columns || _header->capacity != segment_rows || _header->count > segment_rows)
+		return false;
+
+	// every column is a multiple of 64 bytes long, so all of them stay aligned
+	char* _column = _segment.file.data() + sizeof(s_segmentHeader);
+
+	for (size_t i = 0; i < _columns; ++i)
+	{
+		_segment.columns[i] = _column;
+		_column += _widths[i] * segment_rows;
+	}
+
+	_segment.count = &_header->count;
+	_series.segments.push_back(std::move(_segment));
+
+	return true;
+}
+
+TickStore::s_segment* TickStore::f_writable(s_series& _series)
+{
+	if (_series.segments.empty() || *_series.segments.back().count >= segment_rows)
+	{
+		if (!f_open(_series, _series.segments.size(), true))
+			return nullptr;
+	}
+
+	return &_series.segments.back();
+}
+
+std::int64_t TickStore::f_lastKey(const s_series& _series) const
+{
+	// only the last segment may be partly filled, an empty one may follow a full one
+	for (auto _segment = _series.segments.rbegin(); _segment != _series.segments.rend(); ++_segment)
+	{
+		std::uint64_t _count = *_segment->count;
+
+		if (_count)
+			return reinterpret_cast<const std::int64_t*>(_segment->columns[0])[_count - 1];
+	}
+
+	return std::numeric_limits<std::int64_t>::min();
+}
+
+void TickStore::f_range(const s_series& _series, size_t _column, std::int64_t _from, std::int64_t _to, const std::function<void(const s_segment&, size_t, size_t)>& _visit) const
+{
+	if (_from > _to)
+		return;
+
+	for (const s_segment& _segment : _series.segments)
+	{
+		size_t _count = static_cast<size_t>(*_segment.count);
+		if (!_count)
+			continue;
+
+		const std::int64_t* _values = reinterpret_cast<const std::int64_t*>(_segment.columns[_column]);
+
+		// segments follow each other in order, the ones before and after the range are skipped
+		if (_values[_count - 1] < _from)
+			continue;
+
+		if (_values[0] > _to)
+			break;
+
+		size_t _begin = std::lower_bound(_values, _values + _count, _from) - _values;
+		size_t _end = std::upper_bound(_values + _begin, _values + _count, _to) - _values;
+
+		if (_begin < _end)
+			_visit(_segment, _begin, _end);
+	}
+}
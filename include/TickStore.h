@@ -0,0 +1,214 @@
+/*
+	Copyright (c) 2019 Maciej Goncerz <https://github.com/Paurin1>.
+	Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+	TickStore class keeps trades and graph's points on disk, so they are
+	downloaded only once. Every market's trades and every market and
+	interval's points form a series of segment files in the store
+	directory, i.e. trades-BTCPLN.000000.seg, graph-BTCPLN-90m.000000.seg.
+
+	A segment holds up to segment_rows rows column by column, every column
+	a fixed-width array of its own, and is memory-mapped as a whole. Rows
+	are only appended, in order of tid (trades) or time (points): rows
+	not newer than the last stored one are skipped, so overlapping pages
+	may be appended as they are downloaded. Range scans find segments by
+	their first and last key and rows inside by binary search, then hand
+	out spans pointing straight into the mapped columns. Trades are looked
+	up by time the same way, as the exchange gives ids in order of time.
+
+	Appended rows are counted in segment's header after they're written,
+	so a crashed process leaves no half-written rows. flush() waits until
+	they reach the disk.
+
+	The store is not thread safe and a directory may be used by one store.
+*/
+
+#ifndef TICKSTORE_H
+#define TICKSTORE_H
+
+#include <cstddef>		// size_t
+#include <cstdint>		// int64_t, uint8_t, uint64_t
+#include <string>		// string
+#include <vector>		// vector
+#include <map>			// map
+#include <functional>	// function
+#include <limits>		// numeric_limits
+
+// Memory mapping of segment files
+#include "MappedFile.h"
+
+// Defines s_trade, s_graph and s_graphPoint
+#include "PublicApiDataStructures.h"
+
+class TickStore
+{
+public:
+	/**
+		Number of rows in one segment file
+	*/
+	static constexpr size_t segment_rows = 65536;
+
+	/**
+		Trades of one segment, pointers into the mapped file valid as long as the store
+	*/
+	struct s_tradeSpan
+	{
+		const std::int64_t* tid;
+		const std::int64_t* date;
+		const double* price;
+		const double* amount;
+		const std::uint8_t* type;	// 0 is buy, 1 is sell, 2 anything else
+		size_t count;
+
+		/**
+			Copies one trade out of the columns
+		*/
+		s_trade trade(size_t _index) const;
+	};
+
+	/**
+		Points of one segment, pointers into the mapped file valid as long as the store
+	*/
+	struct s_pointSpan
+	{
+		const std::int64_t* time;
+		const double* open;
+		const double* high;
+		const double* low;
+		const double* close;
+		const double* vol;
+		size_t count;
+
+		/**
+			Copies one point out of the columns
+		*/
+		s_graphPoint point(size_t _index) const;
+	};
+
+	typedef std::function<void(const s_tradeSpan&)> trade_scanner;
+	typedef std::function<void(const s_pointSpan&)> point_scanner;
+
+	/**
+		@param _directory existing directory of segment files
+	*/
+	explicit TickStore(std::string _directory);
+
+	TickStore(const TickStore&) = delete;
+	TickStore& operator=(const TickStore&) = delete;
+
+	/**
+		Appends trades of a market in order of tid, those not newer than the last stored one are skipped
+
+		@return number of trades stored
+	*/
+	size_t append(const std::string& _market, const std::vector<s_trade>& _trades);
+
+	/**
+		Appends points of a market's graph in order of time, those not newer than the last stored one are skipped
+
+		@return number of points stored
+	*/
+	size_t append(const std::string& _market, const std::string& _interval, const CandleColumns& _points);
+
+	/**
+		Appends points of a graph returned by BitmarketPublic::graphs()
+	*/
+	size_t append(const s_graph& _graph);
+
+	/**
+		Calls _scanner with trades whose tid is between _from and _to (both included), one span per segment
+	*/
+	void scanTrades(const std::string& _market, long _from, long _to, const trade_scanner& _scanner);
+
+	/**
+		Calls _scanner with trades made between _from and _to (both included, seconds since Unix epoch)
+	*/
+	void scanTradesByTime(const std::string& _market, long _from, long _to, const trade_scanner& _scanner);
+
+	/**
+		Calls _scanner with points whose time is between _from and _to (both included)
+	*/
+	void scanPoints(const std::string& _market, const std::string& _interval, long _from, long _to, const point_scanner& _scanner);
+
+	/**
+		Copies trades whose tid is between _from and _to
+	*/
+	std::vector<s_trade> trades(const std::string& _market, long _from = 0, long _to = std::numeric_limits<long>::max());
+
+	/**
+		Appends points whose time is between _from and _to to _result
+	*/
+	void points(const std::string& _market, const std::string& _interval, CandleColumns& _result, long _from = 0, long _to = std::numeric_limits<long>::max());
+
+	/**
+		Returns tid of the newest stored trade, -1 if there's none. Downloads may continue from it
+	*/
+	long lastTid(const std::string& _market);
+
+	/**
+		Returns time of the newest stored point, -1 if there's none
+	*/
+	long lastTime(const std::string& _market, const std::string& _interval);
+
+	/**
+		Writes appended rows of every open segment to the disk
+
+		@return false if some segment couldn't be written
+	*/
+	bool flush();
+
+private:
+	enum e_kind
+	{
+		e_trades,
+		e_points
+	};
+
+	struct s_segment
+	{
+		MappedFile file;
+		std::uint64_t* count;		// number of rows, in the header
+		char* columns[6];
+	};
+
+	struct s_series
+	{
+		e_kind kind;
+		std::string name;
+		std::vector<s_segment> segments;
+	};
+
+	/**
+		Returns series of given name, opening its segment files the first time
+	*/
+	s_series& f_series(const std::string& _name, e_kind _kind);
+
+	/**
+		Maps segment file of given number, creating it if _create is set
+
+		@return false if there's no valid segment
+	*/
+	bool f_open(s_series& _series, size_t _number, bool _create);
+
+	/**
+		Returns the last segment if it has room for more rows, otherwise a new one
+
+		@return nullptr if a new segment couldn't be created
+	*/
+	s_segment* f_writable(s_series& _series);
+
+	/**
+		Returns key (column 0) of the newest row, lowest int64 value if there's none
+	*/
+	std::int64_t f_lastKey(const s_series& _series) const;
+
+	/**
+		Calls _visit with every segment's range of rows whose value in given sorted column is between _from and _to
+	*/
+	void f_range(const s_series& _series, size_t _column, std::int64_t _from, std::int64_t _to, const std::function<void(const s_segment&, size_t, size_t)>& _visit) const;
+
+	std::string m_directory;
+	std::map<std::string, s_series> m_series;
+};
+
+#endif
@@ -0,0 +1,403 @@
+/*
+	Copyright (c) 2019 Maciej Goncerz <https://github.com/Paurin1>.
+	Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+	More detailed descriptions are in TradeBackfill.h file.
+*/
+
+#include "TradeBackfill.h"
+
+#include <algorithm>	// min, max, sort
+#include <fstream>		// ifstream, ofstream
+#include <cstdio>		// rename, remove
+
+namespace
+{
+	// number of trades trades.json returns at most, a shorter page is the newest one
+	const size_t page_size = 500;
+
+	// failed page is repeated after 2, 4, 8 and 16 seconds, then the market is given up
+	const unsigned max_attempts = 5;
+}
+
+TradeBackfill::TradeBackfill(BitmarketPublic& _api, EventLoop& _loop, trades_sink _sink, std::shared_ptr<RateLimiter> _budget) :
+	m_api(_api), m_loop(_loop), m_sink(std::move(_sink)), m_budget(_budget ? _budget : std::make_shared<RateLimiter>(1.0, 5.0)),
+	m_pipeline(4), m_nextGeneration(1), m_wakePending(false), m_self(std::make_shared<TradeBackfill*>(this))
+{ }
+
+bool TradeBackfill::checkpointFile(std::string _path)
+{
+	m_checkpointPath = std::move(_path);
+
+	std::ifstream _file(m_checkpointPath);
+	if (!_file)
+		return false;
+
+	// one "market tid" line per market
+	std::string _market;
+	long _tid;
+
+	while (_file >> _market >> _tid)
+	{
+		auto _entry = m_progress.emplace(_market, _tid);
+		if (!_entry.second)
+			_entry.first->second = std::max(_entry.first->second, _tid);
+	}
+
+	return true;
+}
+
+void TradeBackfill::start(std::string _market, long _since, long _until)
+{
+	// a market found in the checkpoint continues after the last delivered trade
+	auto _saved = m_progress.find(_market);
+	if (_saved != m_progress.end())
+		_since = std::max(_since, _saved->second);
+
+	m_progress[_market] = _since;
+
+	unsigned long _generation = m_nextGeneration++;
+	s_market& _state = m_markets[_market];
+	_state = { _since, _until, _since, static_cast<long>(page_size), false, 0, _generation, {} };
+
+	std::weak_ptr<TradeBackfill*> _self = m_self;
+
+	// there's nothing to download, it's reported from the loop like every other end
+	if (_until >= 0 && _since >= _until)
+	{
+		m_loop.post([_self, _market, _generation]()
+		{
+			auto _backfill = _self.lock();
+			if (!_backfill)
+				return;
+
+			auto _found = (*_backfill)->m_markets.find(_market);
+			if (_found != (*_backfill)->m_markets.end() && _found->second.generation == _generation)
+				(*_backfill)->f_finish(_market, true);
+		});
+
+		return;
+	}
+
+	// dispatching is posted so that markets started before the loop runs share the budget from the first request
+	m_loop.post([_self]()
+	{
+		if (auto _backfill = _self.lock())
+			(*_backfill)->f_dispatch();
+	});
+}
+
+void TradeBackfill::stop(const std::string& _market)
+{
+	m_markets.erase(_market);
+}
+
+void TradeBackfill::onFinished(finished_callback _callback)
+{
+	m_finished = std::move(_callback);
+}
+
+void TradeBackfill::pipeline(size_t _requests)
+{
+	m_pipeline = std::max<size_t>(_requests, 1);
+}
+
+long TradeBackfill::progress(const std::string& _market) const
+{
+	auto _found = m_progress.find(_market);
+
+	return _found != m_progress.end() ? _found->second : -1;
+}
+
+size_t TradeBackfill::active() const
+{
+	return m_markets.size();
+}
+
+void TradeBackfill::f_dispatch()
+{
+	std::chrono::steady_clock::time_point _now = std::chrono::steady_clock::now();
+	std::chrono::steady_clock::time_point _next = std::chrono::steady_clock::time_point::max();
+
+	// one page of every market per round, so markets share the budget evenly
+	bool _sent = true;
+	bool _exhausted = false;
+
+	while (_sent && !_exhausted)
+	{
+		_sent = false;
+
+		for (auto& _market : m_markets)
+		{
+			long _cursor = f_ready(_market.second, _now, _next);
+			if (_cursor < 0)
+				continue;
+
+			if (!m_budget->tryAcquire())
+			{
+				// the page stays waiting for the next token
+				_next = std::min(_next, _now + m_budget->waitTime());
+				_exhausted = true;
+				break;
+			}
+
+			f_request(_market.first, _market.second, _cursor);
+			_sent = true;
+		}
+	}
+
+	if (_next != std::chrono::steady_clock::time_point::max())
+		f_wakeAt(_next);
+}
+
+long TradeBackfill::f_ready(s_market& _market, std::chrono::steady_clock::time_point _now, std::chrono::steady_clock::time_point& _next)
+{
+	if (_market.inFlight >= m_pipeline)
+		return -1;
+
+	// repeated pages and pages filling gaps go first, they hold up delivery of everything after them
+	for (auto& _page : _market.pages)
+	{
+		if (_page.second.inFlight || _page.second.received)
+			continue;
+
+		if (_page.second.due <= _now)
+			return _page.first;
+
+		_next = std::min(_next, _page.second.due);
+	}
+
+	// pages received ahead of a missing one aren't piled up without limit
+	if (_market.headReached || _market.pages.size() >= m_pipeline * 4)
+		return -1;
+
+	if (_market.until >= 0 && _market.next >= _market.until)
+		return -1;
+
+	long _cursor = _market.next;
+	_market.next += _market.stride;
+
+	if (!_market.pages.emplace(_cursor, s_page{ false, false, 0, _now, nullptr }).second)
+		return -1;
+
+	return _cursor;
+}
+
+void TradeBackfill::f_request(const std::string& _name, s_market& _market, long _cursor)
+{
+	_market.pages[_cursor].inFlight = true;
+	++_market.inFlight;
+
+	std::weak_ptr<TradeBackfill*> _self = m_self;
+	EventLoop* _loop = &m_loop;
+	unsigned long _generation = _market.generation;
+
+	// called on executor's thread, the result is handed over to the loop
+	m_api.tradesAsync([_self, _loop, _name, _generation, _cursor](std::shared_ptr<const s_trades> _trades)
+	{
+		_loop->post([_self, _name, _generation, _cursor, _trades]()
+		{
+			if (auto _backfill = _self.lock())
+				(*_backfill)->f_response(_name, _generation, _cursor, _trades);
+		});
+	}, static_cast<int>(_cursor), _name);
+}
+
+void TradeBackfill::f_response(const std::string& _name, unsigned long _generation, long _cursor, std::shared_ptr<const s_trades> _trades)
+{
+	auto _found = m_markets.find(_name);
+
+	// the market has been stopped or started again in the meantime
+	if (_found == m_markets.end() || _found->second.generation != _generation)
+		return;
+
+	s_market& _market = _found->second;
+	--_market.inFlight;
+
+	auto _page = _market.pages.find(_cursor);
+	if (_page == _market.pages.end())
+	{
+		f_dispatch();
+		return;
+	}
+
+	_page->second.inFlight = false;
+
+	if (!_trades)
+	{
+		if (++_page->second.attempts >= max_attempts)
+			f_finish(_name, false);
+		else
+			_page->second.due = std::chrono::steady_clock::now() + std::chrono::seconds(1 << _page->second.attempts);
+
+		f_dispatch();
+		return;
+	}
+
+	// the result may be shared with other callers and the cache, so a copy is sorted
+	std::shared_ptr<s_trades> _sorted = std::make_shared<s_trades>(*_trades);
+
+	std::sort(_sorted->trades.begin(), _sorted->trades.end(), [](const s_trade& _a, const s_trade& _b)
+	{
+		return _a.tid < _b.tid;
+	});
+
+	_page->second.received = true;
+	_page->second.trades = _sorted;
+
+	// nothing follows a page that is not full, pages further ahead aren't needed
+	if (_sorted->trades.size() < page_size)
+		_market.headReached = true;
+
+	f_deliver(_name);
+	f_dispatch();
+}
+
+bool TradeBackfill::f_deliver(const std::string& _name)
+{
+	for (;;)
+	{
+		auto _found = m_markets.find(_name);
+		if (_found == m_markets.end())
+			return false;
+
+		s_market& _market = _found->second;
+		unsigned long _generation = _market.generation;
+
+		auto _front = _market.pages.begin();
+		if (_front == _market.pages.end() || !_front->second.received)
+			return true;
+
+		long _cursor = _front->first;
+		std::shared_ptr<s_trades> _page = _front->second.trades;
+		_market.pages.erase(_front);
+
+		const std::vector<s_trade>& _trades = _page->trades;
+		bool _full = _trades.size() >= page_size;
+		long _reached = _trades.empty() ? _cursor : std::max(_cursor, _trades.back().tid);
+
+		// trades overlapping pages delivered before are dropped
+		std::vector<s_trade> _fresh;
+		_fresh.reserve(_trades.size());
+
+		for (const s_trade& _trade : _trades)
+		{
+			if (_trade.tid <= _market.delivered || (_market.until >= 0 && _trade.tid > _market.until))
+				continue;
+
+			_fresh.push_back(_trade);
+			_market.delivered = _trade.tid;
+		}
+
+		bool _done = !_full || (_market.until >= 0 && _reached >= _market.until);
+
+		if (!_done)
+		{
+			// ids are spread the way the last page was, new cursors follow that
+			_market.stride = std::max(_reached - _cursor, static_cast<long>(page_size));
+
+			// pages not sent yet whose trades this one already covered aren't needed
+			for (auto _other = _market.pages.begin(); _other != _market.pages.end() && _other->first <= _reached;)
+			{
+				if (!_other->second.inFlight && !_other->second.received)
+					_other = _market.pages.erase(_other);
+				else
+					++_other;
+			}
+
+			// a guessed cursor skipped some trades, a page starting right after this one fills the gap
+			auto _following = _market.pages.begin();
+
+			if (_following == _market.pages.end())
+				_market.next = std::min(_market.next, _reached);
+			else if (_following->first > _reached)
+				_market.pages.emplace(_reached, s_page{ false, false, 0, std::chrono::steady_clock::now(), nullptr });
+		}
+
+		if (!_fresh.empty())
+		{
+			m_progress[_name] = _market.delivered;
+
+			if (m_sink)
+				m_sink(_name, _fresh);
+
+			// progress is saved once the sink has the trades, a crash may deliver a page twice but never skips one
+			f_save();
+		}
+
+		// the sink may have stopped or started the market again
+		_found = m_markets.find(_name);
+		if (_found == m_markets.end() || _found->second.generation != _generation)
+			return false;
+
+		if (_done)
+		{
+			f_finish(_name, true);
+			return false;
+		}
+	}
+}
+
+void TradeBackfill::f_finish(const std::string& _name, bool _completed)
+{
+	m_markets.erase(_name);
+	f_save();
+
+	if (m_finished)
+		m_finished(_name, _completed);
+}
+
+void TradeBackfill::f_save()
+{
+	if (m_checkpointPath.empty())
+		return;
+
+	// written aside and renamed over the old file, so a crash never leaves half of it
+	std::string _temporary = m_checkpointPath + ".tmp";
+
+	{
+		std::ofstream _file(_temporary, std::ios::trunc);
+		if (!_file)
+			return;
+
+		for (const auto& _market : m_progress)
+			_file << _market.first << ' ' << _market.second << '\n';
+
+		if (!_file.flush())
+			return;
+	}
+
+	// rename doesn't replace an existing file on Windows
+	if (std::rename(_temporary.c_str(), m_checkpointPath.c_str()) != 0)
+	{
+		std::remove(m_checkpointPath.c_str());
+		std::rename(_temporary.c_str(), m_checkpointPath.c_str());
+	}
+}
+
+void TradeBackfill::f_wakeAt(std::chrono::steady_clock::time_point _time)
+{
+	// a wake-up already posted for an earlier time will dispatch again anyway
+	if (m_wakePending && m_wakeAt <= _time)
+		return;
+
+	m_wakeAt = _time;
+	m_wakePending = true;
+
+	std::weak_ptr<TradeBackfill*> _self = m_self;
+	std::chrono::steady_clock::duration _delay = _time - std::chrono::steady_clock::now();
+
+	// rounded up, so the handler doesn't run before the time and find nothing to do
+	m_loop.postAfter(std::chrono::duration_cast<std::chrono::milliseconds>(_delay) + std::chrono::milliseconds(1), [_self, _time]()
+	{
+		auto _backfill = _self.lock();
+		if (!_backfill)
+			return;
+
+		// a wake-up replaced by an earlier one has nothing to clear
+		if ((*_backfill)->m_wakeAt == _time)
+			(*_backfill)->m_wakePending = false;
+
+		(*_backfill)->f_dispatch();
+	});
+}
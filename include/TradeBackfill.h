@@ -0,0 +1,182 @@
+/*
+	Copyright (c) 2019 Maciej Goncerz <https://github.com/Paurin1>.
+	Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+	TradeBackfill class downloads history of trades of many markets at once.
+	trades.json returns 500 trades following given trade id, so history is
+	walked page by page. Pages are requested ahead, with cursors guessed from
+	ids seen so far, several at a time per market within the RateLimiter's
+	budget. Pages are handed to the sink in order of trade ids: trades that
+	were already delivered are dropped and when a guessed cursor skipped
+	some trades, a page filling the gap is requested before going on.
+
+	Progress of every market may be saved to a checkpoint file after every
+	delivered page, a later backfill started with the same file resumes
+	from there.
+
+	Requests run on BitmarketPublic's executor, the engine and callbacks run
+	on given EventLoop's thread. Methods must be called from that thread too
+	(or before the loop is run).
+*/
+
+#ifndef TRADEBACKFILL_H
+#define TRADEBACKFILL_H
+
+#include <string>		// string
+#include <vector>		// vector
+#include <map>			// map
+#include <memory>		// shared_ptr, weak_ptr
+#include <functional>	// function
+#include <chrono>		// steady_clock
+
+// Public API whose trades are downloaded
+#include "BitmarketPublic.h"
+
+// Loop the engine runs on
+#include "EventLoop.h"
+
+// Token bucket limiting number of requests
+#include "RateLimiter.h"
+
+class TradeBackfill
+{
+public:
+	/**
+		Receives trades of a market, sorted by id, every trade exactly once
+	*/
+	typedef std::function<void(const std::string& _market, const std::vector<s_trade>& _trades)> trades_sink;
+
+	/**
+		Called when a market is done: _completed is false if requests kept failing
+	*/
+	typedef std::function<void(const std::string& _market, bool _completed)> finished_callback;
+
+	/**
+		@param _api object requests are sent through, must outlive the engine
+		@param _loop loop running the engine and callbacks
+		@param _sink receiver of downloaded trades
+		@param _budget limiter shared with other users of the API, by default one request per second with bursts of five
+	*/
+	TradeBackfill(BitmarketPublic& _api, EventLoop& _loop, trades_sink _sink, std::shared_ptr<RateLimiter> _budget = nullptr);
+
+	TradeBackfill(const TradeBackfill&) = delete;
+	TradeBackfill& operator=(const TradeBackfill&) = delete;
+
+	/**
+		Sets file progress is saved to, markets saved there resume from the last delivered trade
+
+		@return false if there's no checkpoint to read yet
+	*/
+	bool checkpointFile(std::string _path);
+
+	/**
+		Starts downloading trades of a market, a running download of the market is restarted
+
+		@param _since id of the trade to start after, 0 starts from the oldest one
+		@param _until id of the last wanted trade, -1 continues until the newest one
+	*/
+	void start(std::string _market, long _since = 0, long _until = -1);
+
+	/**
+		Stops downloading trades of a market, responses in flight are dropped
+	*/
+	void stop(const std::string& _market);
+
+	/**
+		Sets function called when a market is done
+	*/
+	void onFinished(finished_callback _callback);
+
+	/**
+		Sets number of requests of one market that may be in flight at once, 4 by default
+	*/
+	void pipeline(size_t _requests);
+
+	/**
+		Returns id of the last trade delivered, -1 if nothing is known about the market
+	*/
+	long progress(const std::string& _market) const;
+
+	/**
+		Returns number of markets being downloaded
+	*/
+	size_t active() const;
+
+private:
+	// one page requested for a cursor
+	struct s_page
+	{
+		bool inFlight;
+		bool received;
+		unsigned attempts;
+		std::chrono::steady_clock::time_point due;
+		std::shared_ptr<s_trades> trades;
+	};
+
+	struct s_market
+	{
+		long delivered;			// id of the last trade given to the sink
+		long until;
+		long next;				// cursor of the next new page
+		long stride;			// distance between cursors of new pages
+		bool headReached;		// a page that was not full has been received, there's nothing after it
+		size_t inFlight;
+		unsigned long generation;
+		std::map<long, s_page> pages;	// by cursor
+	};
+
+	/**
+		Sends pages that are due while the budget allows, one market after another, and sets the next wake-up
+	*/
+	void f_dispatch();
+
+	/**
+		Returns cursor of a page of the market that may be sent now, creating a new one if there's room
+
+		@return -1 if there's none
+	*/
+	long f_ready(s_market& _market, std::chrono::steady_clock::time_point _now, std::chrono::steady_clock::time_point& _next);
+
+	void f_request(const std::string& _name, s_market& _market, long _cursor);
+
+	void f_response(const std::string& _name, unsigned long _generation, long _cursor, std::shared_ptr<const s_trades> _trades);
+
+	/**
+		Gives received pages to the sink in order, as long as the first page has arrived
+
+		@return false if the market has been finished or replaced in the meantime
+	*/
+	bool f_deliver(const std::string& _name);
+
+	void f_finish(const std::string& _name, bool _completed);
+
+	/**
+		Writes progress of every market to the checkpoint file
+	*/
+	void f_save();
+
+	void f_wakeAt(std::chrono::steady_clock::time_point _time);
+
+	BitmarketPublic& m_api;
+	EventLoop& m_loop;
+	trades_sink m_sink;
+	finished_callback m_finished;
+	std::shared_ptr<RateLimiter> m_budget;
+
+	std::map<std::string, s_market> m_markets;
+	size_t m_pipeline;
+	unsigned long m_nextGeneration;
+
+	// last delivered trade of every market ever started or read from the checkpoint
+	std::map<std::string, long> m_progress;
+	std::string m_checkpointPath;
+
+	// earliest wake-up already posted to the loop
+	std::chrono::steady_clock::time_point m_wakeAt;
+	bool m_wakePending;
+
+	// handlers posted to the loop hold a weak pointer and do nothing once the engine is gone
+	std::shared_ptr<TradeBackfill*> m_self;
+};
+
+#endif
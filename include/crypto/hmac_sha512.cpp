@@ -6,7 +6,7 @@
 
 #include <string.h>
 
-CHMAC_SHA512::CHMAC_SHA512(const unsigned char* key, size_t keylen)
+CHMAC_SHA512::Context::Context(const unsigned char* key, size_t keylen)
 {
     unsigned char rkey[128];
     if (keylen <= 128) {
@@ -26,9 +26,54 @@ CHMAC_SHA512::CHMAC_SHA512(const unsigned char* key, size_t keylen)
     inner.Write(rkey, 128);
 }
 
+CHMAC_SHA512::CHMAC_SHA512(const unsigned char* key, size_t keylen) : CHMAC_SHA512(Context(key, keylen))
+{
+}
+
+CHMAC_SHA512::CHMAC_SHA512(const Context& ctx) : outer(ctx.outer), inner(ctx.inner)
+{
+}
+
+CHMAC_SHA512& CHMAC_SHA512::Reset(const Context& ctx)
+{
+    outer = ctx.outer;
+    inner = ctx.inner;
+    return *this;
+}
+
 void CHMAC_SHA512::Finalize(unsigned char hash[OUTPUT_SIZE])
 {
     unsigned char temp[64];
     inner.Finalize(temp);
     outer.Write(temp, 64).Finalize(hash);
 }
+
+void CHMAC_SHA512::SignBatch(const Context& ctx, const unsigned char* const data[], const size_t lens[], unsigned char* const hashes[], size_t count)
+{
+    static const size_t group = 8;
+    CSHA512 hashers[group];
+    CSHA512* ptrs[group];
+    unsigned char temp[group][64];
+    unsigned char* temps[group];
+    size_t templens[group];
+    for (size_t i = 0; i < group; i++) {
+        ptrs[i] = &hashers[i];
+        temps[i] = temp[i];
+        templens[i] = 64;
+    }
+
+    while (count) {
+        size_t n = count < group ? count : group;
+        for (size_t i = 0; i < n; i++)
+            hashers[i] = ctx.inner;
+        CSHA512::FinalizeBatch(ptrs, data, lens, temps, n);
+        for (size_t i = 0; i < n; i++)
+            hashers[i] = ctx.outer;
+        CSHA512::FinalizeBatch(ptrs, temps, templens, hashes, n);
+
+        data += n;
+        lens += n;
+        hashes += n;
+        count -= n;
+    }
+}
@@ -20,13 +20,36 @@ private:
 public:
     static const size_t OUTPUT_SIZE = 64;
 
+    /** Inner and outer hash states with the padded key already absorbed.
+     *  Computing it costs two compressions; it can then be reused for any
+     *  number of messages signed with the same key. */
+    class Context
+    {
+    private:
+        CSHA512 outer;
+        CSHA512 inner;
+
+        friend class CHMAC_SHA512;
+
+    public:
+        Context(const unsigned char* key, size_t keylen);
+    };
+
     CHMAC_SHA512(const unsigned char* key, size_t keylen);
+    /** Start a message from a keyed context, the key is not hashed again. */
+    explicit CHMAC_SHA512(const Context& ctx);
     CHMAC_SHA512& Write(const unsigned char* data, size_t len)
     {
         inner.Write(data, len);
         return *this;
     }
     void Finalize(unsigned char hash[OUTPUT_SIZE]);
+    /** Drop written data and return to the keyed state of ctx. */
+    CHMAC_SHA512& Reset(const Context& ctx);
+
+    /** Sign count messages with the same key at once, the messages are hashed
+     *  side by side in SIMD lanes (see CSHA512::FinalizeBatch()). */
+    static void SignBatch(const Context& ctx, const unsigned char* const data[], const size_t lens[], unsigned char* const hashes[], size_t count);
 };
 
 #endif // BITCOIN_CRYPTO_HMAC_SHA512_H
@@ -7,6 +7,7 @@
 
 #include <stdint.h>
 #include <stdlib.h>
+#include <string>
 
 /** A hasher class for SHA-512. */
 class CSHA512
@@ -23,6 +24,19 @@ public:
     CSHA512& Write(const unsigned char* data, size_t len);
     void Finalize(unsigned char hash[OUTPUT_SIZE]);
     CSHA512& Reset();
+
+    /** Write data[i] to hashers[i] and finalize every one of them, hashing the
+     *  messages side by side in SIMD lanes (see SHA512BatchLanes()). data may be
+     *  null when nothing is left to write. Hashers end up as after Finalize(). */
+    static void FinalizeBatch(CSHA512* const hashers[], const unsigned char* const data[], const size_t lens[], unsigned char* const hashes[], size_t count);
 };
 
+/** Autodetect the best available SHA-512 implementation.
+ *  Runs once at startup; returns the name of the implementation in use.
+ */
+std::string SHA512AutoDetect();
+
+/** Number of messages CSHA512::FinalizeBatch() hashes at once, 1 without SIMD support. */
+size_t SHA512BatchLanes();
+
 #endif // BITCOIN_CRYPTO_SHA512_H
@@ -0,0 +1,277 @@
+// Copyright (c) 2019 Maciej Goncerz <https://github.com/Paurin1>.
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+//
+// SHA-512 transforms for x86-64 CPUs with AVX2 or AVX-512. The message
+// schedule is expanded two words per instruction in vector registers
+// and added to the round constants before the rounds start; the rounds
+// themselves stay scalar, using BMI2 rotations.
+//
+// TransformMulti variants process one block of 4 (AVX2) or 8 (AVX-512)
+// independent messages, every vector lane holds the state of one of them.
+//
+// All of them are selected at runtime by SHA512AutoDetect() in sha512.cpp.
+
+#if defined(__x86_64__) || defined(__amd64__) || defined(_M_X64)
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <immintrin.h>
+
+#include "common.h"
+
+#if defined(__GNUC__)
+#define SHA512_TARGET_AVX2 __attribute__((target("avx2,bmi2")))
+#define SHA512_TARGET_AVX512 __attribute__((target("avx2,bmi2,avx512f,avx512vl")))
+#else
+#define SHA512_TARGET_AVX2
+#define SHA512_TARGET_AVX512
+#endif
+
+namespace
+{
+alignas(64) const uint64_t K[80] = {
+    0x428a2f98d728ae22ull, 0x7137449123ef65cdull, 0xb5c0fbcfec4d3b2full, 0xe9b5dba58189dbbcull,
+    0x3956c25bf348b538ull, 0x59f111f1b605d019ull, 0x923f82a4af194f9bull, 0xab1c5ed5da6d8118ull,
+    0xd807aa98a3030242ull, 0x12835b0145706fbeull, 0x243185be4ee4b28cull, 0x550c7dc3d5ffb4e2ull,
+    0x72be5d74f27b896full, 0x80deb1fe3b1696b1ull, 0x9bdc06a725c71235ull, 0xc19bf174cf692694ull,
+    0xe49b69c19ef14ad2ull, 0xefbe4786384f25e3ull, 0x0fc19dc68b8cd5b5ull, 0x240ca1cc77ac9c65ull,
+    0x2de92c6f592b0275ull, 0x4a7484aa6ea6e483ull, 0x5cb0a9dcbd41fbd4ull, 0x76f988da831153b5ull,
+    0x983e5152ee66dfabull, 0xa831c66d2db43210ull, 0xb00327c898fb213full, 0xbf597fc7beef0ee4ull,
+    0xc6e00bf33da88fc2ull, 0xd5a79147930aa725ull, 0x06ca6351e003826full, 0x142929670a0e6e70ull,
+    0x27b70a8546d22ffcull, 0x2e1b21385c26c926ull, 0x4d2c6dfc5ac42aedull, 0x53380d139d95b3dfull,
+    0x650a73548baf63deull, 0x766a0abb3c77b2a8ull, 0x81c2c92e47edaee6ull, 0x92722c851482353bull,
+    0xa2bfe8a14cf10364ull, 0xa81a664bbc423001ull, 0xc24b8b70d0f89791ull, 0xc76c51a30654be30ull,
+    0xd192e819d6ef5218ull, 0xd69906245565a910ull, 0xf40e35855771202aull, 0x106aa07032bbd1b8ull,
+    0x19a4c116b8d2d0c8ull, 0x1e376c085141ab53ull, 0x2748774cdf8eeb99ull, 0x34b0bcb5e19b48a8ull,
+    0x391c0cb3c5c95a63ull, 0x4ed8aa4ae3418acbull, 0x5b9cca4f7763e373ull, 0x682e6ff3d6b2b8a3ull,
+    0x748f82ee5defb2fcull, 0x78a5636f43172f60ull, 0x84c87814a1f0ab72ull, 0x8cc702081a6439ecull,
+    0x90befffa23631e28ull, 0xa4506cebde82bde9ull, 0xbef9a3f7b2c67915ull, 0xc67178f2e372532bull,
+    0xca273eceea26619cull, 0xd186b8c721c0c207ull, 0xeada7dd6cde0eb1eull, 0xf57d4f7fee6ed178ull,
+    0x06f067aa72176fbaull, 0x0a637dc5a2c898a6ull, 0x113f9804bef90daeull, 0x1b710b35131c471bull,
+    0x28db77f523047d84ull, 0x32caab7b40c72493ull, 0x3c9ebe0a15c9bebcull, 0x431d67c49c100d4cull,
+    0x4cc5d4becb3e42b6ull, 0x597f299cfc657e2aull, 0x5fcb6fab3ad6faecull, 0x6c44198c4a475817ull
+};
+
+/** Round function shared by both transforms, k is already added to w. */
+#define SHA512_ROUND(a, b, c, d, e, f, g, h, kw)                                                                        \
+    do {                                                                                                                \
+        uint64_t t1 = h + ((e >> 14 | e << 50) ^ (e >> 18 | e << 46) ^ (e >> 41 | e << 23)) + (g ^ (e & (f ^ g))) + (kw); \
+        uint64_t t2 = ((a >> 28 | a << 36) ^ (a >> 34 | a << 30) ^ (a >> 39 | a << 25)) + ((a & b) | (c & (a | b)));   \
+        d += t1;                                                                                                        \
+        h = t1 + t2;                                                                                                    \
+    } while (0)
+
+/** Eight rounds, after which the variables are back in their places. */
+#define SHA512_ROUNDS8(wk)                                   \
+    do {                                                     \
+        SHA512_ROUND(a, b, c, d, e, f, g, h, (wk)[0]);       \
+        SHA512_ROUND(h, a, b, c, d, e, f, g, (wk)[1]);       \
+        SHA512_ROUND(g, h, a, b, c, d, e, f, (wk)[2]);       \
+        SHA512_ROUND(f, g, h, a, b, c, d, e, (wk)[3]);       \
+        SHA512_ROUND(e, f, g, h, a, b, c, d, (wk)[4]);       \
+        SHA512_ROUND(d, e, f, g, h, a, b, c, (wk)[5]);       \
+        SHA512_ROUND(c, d, e, f, g, h, a, b, (wk)[6]);       \
+        SHA512_ROUND(b, c, d, e, f, g, h, a, (wk)[7]);       \
+    } while (0)
+
+/** Runs all 80 rounds on state s with precomputed w + k values. */
+#define SHA512_COMPRESS(s, wk)                                                                            \
+    do {                                                                                                  \
+        uint64_t a = s[0], b = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7];        \
+        for (int r = 0; r < 80; r += 8) {                                                                 \
+            SHA512_ROUNDS8(wk + r);                                                                       \
+        }                                                                                                 \
+        s[0] += a;                                                                                        \
+        s[1] += b;                                                                                        \
+        s[2] += c;                                                                                        \
+        s[3] += d;                                                                                        \
+        s[4] += e;                                                                                        \
+        s[5] += f;                                                                                        \
+        s[6] += g;                                                                                        \
+        s[7] += h;                                                                                        \
+    } while (0)
+
+/** Round of a multi-lane transform, V is a vector of 64-bit lanes. */
+#define SHA512_MULTI_ROUND(a, b, c, d, e, f, g, h, k, w)                                   \
+    do {                                                                                   \
+        V t1 = Add(Add(h, Xor3(Ror<14>(e), Ror<18>(e), Ror<41>(e))), Add(Ch(e, f, g), Add(Set1(k), w))); \
+        V t2 = Add(Xor3(Ror<28>(a), Ror<34>(a), Ror<39>(a)), Maj(a, b, c));               \
+        d = Add(d, t1);                                                                    \
+        h = Add(t1, t2);                                                                   \
+    } while (0)
+
+/** Next word of the message schedule kept in a ring of 16 vectors. */
+#define SHA512_MULTI_EXPAND(w, i)                                                                                        \
+    (w[i] = Add(Add(w[i], Xor3(Ror<1>(w[(i + 1) & 15]), Ror<8>(w[(i + 1) & 15]), Shr(w[(i + 1) & 15], 7))),              \
+                Add(w[(i + 9) & 15], Xor3(Ror<19>(w[(i + 14) & 15]), Ror<61>(w[(i + 14) & 15]), Shr(w[(i + 14) & 15], 6)))))
+
+/** Sixteen rounds starting at round r; the schedule is expanded when r > 0. */
+#define SHA512_MULTI_ROUNDS16(r, W)                                                          \
+    do {                                                                                     \
+        SHA512_MULTI_ROUND(a, b, c, d, e, f, g, h, K[r + 0], W(0));                          \
+        SHA512_MULTI_ROUND(h, a, b, c, d, e, f, g, K[r + 1], W(1));                          \
+        SHA512_MULTI_ROUND(g, h, a, b, c, d, e, f, K[r + 2], W(2));                          \
+        SHA512_MULTI_ROUND(f, g, h, a, b, c, d, e, K[r + 3], W(3));                          \
+        SHA512_MULTI_ROUND(e, f, g, h, a, b, c, d, K[r + 4], W(4));                          \
+        SHA512_MULTI_ROUND(d, e, f, g, h, a, b, c, K[r + 5], W(5));                          \
+        SHA512_MULTI_ROUND(c, d, e, f, g, h, a, b, K[r + 6], W(6));                          \
+        SHA512_MULTI_ROUND(b, c, d, e, f, g, h, a, K[r + 7], W(7));                          \
+        SHA512_MULTI_ROUND(a, b, c, d, e, f, g, h, K[r + 8], W(8));                          \
+        SHA512_MULTI_ROUND(h, a, b, c, d, e, f, g, K[r + 9], W(9));                          \
+        SHA512_MULTI_ROUND(g, h, a, b, c, d, e, f, K[r + 10], W(10));                        \
+        SHA512_MULTI_ROUND(f, g, h, a, b, c, d, e, K[r + 11], W(11));                        \
+        SHA512_MULTI_ROUND(e, f, g, h, a, b, c, d, K[r + 12], W(12));                        \
+        SHA512_MULTI_ROUND(d, e, f, g, h, a, b, c, K[r + 13], W(13));                        \
+        SHA512_MULTI_ROUND(c, d, e, f, g, h, a, b, K[r + 14], W(14));                        \
+        SHA512_MULTI_ROUND(b, c, d, e, f, g, h, a, K[r + 15], W(15));                        \
+    } while (0)
+
+/** Body of TransformMulti for LANES lanes, words are transposed through memory. */
+#define SHA512_MULTI_TRANSFORM(LANES)                                                        \
+    do {                                                                                     \
+        alignas(64) uint64_t t[16][LANES];                                                   \
+        for (int i = 0; i < 16; i++)                                                         \
+            for (int l = 0; l < LANES; l++)                                                  \
+                t[i][l] = ReadBE64(chunks[l] + 8 * i);                                       \
+        V w[16];                                                                             \
+        for (int i = 0; i < 16; i++)                                                         \
+            w[i] = Load(t[i]);                                                               \
+        for (int i = 0; i < 8; i++)                                                          \
+            for (int l = 0; l < LANES; l++)                                                  \
+                t[i][l] = s[l][i];                                                           \
+        V a = Load(t[0]), b = Load(t[1]), c = Load(t[2]), d = Load(t[3]);                    \
+        V e = Load(t[4]), f = Load(t[5]), g = Load(t[6]), h = Load(t[7]);                    \
+        SHA512_MULTI_ROUNDS16(0, SHA512_MULTI_WORD);                                         \
+        for (int r = 16; r < 80; r += 16) {                                                  \
+            SHA512_MULTI_ROUNDS16(r, SHA512_MULTI_NEXT);                                     \
+        }                                                                                    \
+        Store(t[0], Add(a, Load(t[0])));                                                     \
+        Store(t[1], Add(b, Load(t[1])));                                                     \
+        Store(t[2], Add(c, Load(t[2])));                                                     \
+        Store(t[3], Add(d, Load(t[3])));                                                     \
+        Store(t[4], Add(e, Load(t[4])));                                                     \
+        Store(t[5], Add(f, Load(t[5])));                                                     \
+        Store(t[6], Add(g, Load(t[6])));                                                     \
+        Store(t[7], Add(h, Load(t[7])));                                                     \
+        for (int i = 0; i < 8; i++)                                                          \
+            for (int l = 0; l < LANES; l++)                                                  \
+                s[l][i] = t[i][l];                                                           \
+    } while (0)
+
+#define SHA512_MULTI_WORD(i) w[i]
+#define SHA512_MULTI_NEXT(i) SHA512_MULTI_EXPAND(w, i)
+} // namespace
+
+namespace sha512_avx2
+{
+namespace
+{
+template <int n>
+SHA512_TARGET_AVX2 __m128i inline Ror(__m128i x) { return _mm_or_si128(_mm_srli_epi64(x, n), _mm_slli_epi64(x, 64 - n)); }
+SHA512_TARGET_AVX2 __m128i inline sigma0(__m128i x) { return _mm_xor_si128(_mm_xor_si128(Ror<1>(x), Ror<8>(x)), _mm_srli_epi64(x, 7)); }
+SHA512_TARGET_AVX2 __m128i inline sigma1(__m128i x) { return _mm_xor_si128(_mm_xor_si128(Ror<19>(x), Ror<61>(x)), _mm_srli_epi64(x, 6)); }
+} // namespace
+
+SHA512_TARGET_AVX2 void Transform(uint64_t* s, const unsigned char* chunk, size_t blocks)
+{
+    alignas(32) uint64_t w[80];
+    alignas(32) uint64_t wk[80];
+    const __m256i swap = _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+                                          7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+
+    while (blocks--) {
+        for (int i = 0; i < 16; i += 4) {
+            __m256i x = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i*)(chunk + 8 * i)), swap);
+            _mm256_store_si256((__m256i*)(w + i), x);
+            _mm256_store_si256((__m256i*)(wk + i), _mm256_add_epi64(x, _mm256_load_si256((const __m256i*)(K + i))));
+        }
+        // w[t + 1] depends on w[t - 1] at most, so two words are computed at once
+        for (int t = 16; t < 80; t += 2) {
+            __m128i x = _mm_add_epi64(_mm_load_si128((const __m128i*)(w + t - 16)), sigma1(_mm_load_si128((const __m128i*)(w + t - 2))));
+            x = _mm_add_epi64(x, _mm_add_epi64(_mm_loadu_si128((const __m128i*)(w + t - 7)), sigma0(_mm_loadu_si128((const __m128i*)(w + t - 15)))));
+            _mm_store_si128((__m128i*)(w + t), x);
+            _mm_store_si128((__m128i*)(wk + t), _mm_add_epi64(x, _mm_load_si128((const __m128i*)(K + t))));
+        }
+        SHA512_COMPRESS(s, wk);
+        chunk += 128;
+    }
+}
+
+namespace
+{
+typedef __m256i V;
+SHA512_TARGET_AVX2 V inline Load(const uint64_t* p) { return _mm256_load_si256((const __m256i*)p); }
+SHA512_TARGET_AVX2 void inline Store(uint64_t* p, V x) { _mm256_store_si256((__m256i*)p, x); }
+SHA512_TARGET_AVX2 V inline Set1(uint64_t x) { return _mm256_set1_epi64x(x); }
+SHA512_TARGET_AVX2 V inline Add(V x, V y) { return _mm256_add_epi64(x, y); }
+SHA512_TARGET_AVX2 V inline Shr(V x, int n) { return _mm256_srli_epi64(x, n); }
+template <int n>
+SHA512_TARGET_AVX2 V inline Ror(V x) { return _mm256_or_si256(_mm256_srli_epi64(x, n), _mm256_slli_epi64(x, 64 - n)); }
+SHA512_TARGET_AVX2 V inline Xor3(V x, V y, V z) { return _mm256_xor_si256(_mm256_xor_si256(x, y), z); }
+SHA512_TARGET_AVX2 V inline Ch(V x, V y, V z) { return _mm256_xor_si256(z, _mm256_and_si256(x, _mm256_xor_si256(y, z))); }
+SHA512_TARGET_AVX2 V inline Maj(V x, V y, V z) { return _mm256_or_si256(_mm256_and_si256(x, y), _mm256_and_si256(z, _mm256_or_si256(x, y))); }
+} // namespace
+
+SHA512_TARGET_AVX2 void TransformMulti(uint64_t* const s[], const unsigned char* const chunks[])
+{
+    SHA512_MULTI_TRANSFORM(4);
+}
+} // namespace sha512_avx2
+
+namespace sha512_avx512
+{
+namespace
+{
+SHA512_TARGET_AVX512 __m128i inline Xor3(__m128i x, __m128i y, __m128i z) { return _mm_ternarylogic_epi64(x, y, z, 0x96); }
+SHA512_TARGET_AVX512 __m128i inline sigma0(__m128i x) { return Xor3(_mm_ror_epi64(x, 1), _mm_ror_epi64(x, 8), _mm_srli_epi64(x, 7)); }
+SHA512_TARGET_AVX512 __m128i inline sigma1(__m128i x) { return Xor3(_mm_ror_epi64(x, 19), _mm_ror_epi64(x, 61), _mm_srli_epi64(x, 6)); }
+} // namespace
+
+SHA512_TARGET_AVX512 void Transform(uint64_t* s, const unsigned char* chunk, size_t blocks)
+{
+    alignas(64) uint64_t w[80];
+    alignas(64) uint64_t wk[80];
+    const __m256i swap = _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+                                          7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+
+    while (blocks--) {
+        for (int i = 0; i < 16; i += 4) {
+            __m256i x = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i*)(chunk + 8 * i)), swap);
+            _mm256_store_si256((__m256i*)(w + i), x);
+            _mm256_store_si256((__m256i*)(wk + i), _mm256_add_epi64(x, _mm256_load_si256((const __m256i*)(K + i))));
+        }
+        for (int t = 16; t < 80; t += 2) {
+            __m128i x = _mm_add_epi64(_mm_load_si128((const __m128i*)(w + t - 16)), sigma1(_mm_load_si128((const __m128i*)(w + t - 2))));
+            x = _mm_add_epi64(x, _mm_add_epi64(_mm_loadu_si128((const __m128i*)(w + t - 7)), sigma0(_mm_loadu_si128((const __m128i*)(w + t - 15)))));
+            _mm_store_si128((__m128i*)(w + t), x);
+            _mm_store_si128((__m128i*)(wk + t), _mm_add_epi64(x, _mm_load_si128((const __m128i*)(K + t))));
+        }
+        SHA512_COMPRESS(s, wk);
+        chunk += 128;
+    }
+}
+
+namespace
+{
+typedef __m512i V;
+SHA512_TARGET_AVX512 V inline Load(const uint64_t* p) { return _mm512_load_si512((const void*)p); }
+SHA512_TARGET_AVX512 void inline Store(uint64_t* p, V x) { _mm512_store_si512((void*)p, x); }
+SHA512_TARGET_AVX512 V inline Set1(uint64_t x) { return _mm512_set1_epi64(x); }
+SHA512_TARGET_AVX512 V inline Add(V x, V y) { return _mm512_add_epi64(x, y); }
+// masked forms with all lanes selected, the plain ones trip GCC's uninitialized warning
+SHA512_TARGET_AVX512 V inline Shr(V x, int n) { return _mm512_mask_srli_epi64(x, 0xff, x, n); }
+template <int n>
+SHA512_TARGET_AVX512 V inline Ror(V x) { return _mm512_mask_ror_epi64(x, 0xff, x, n); }
+SHA512_TARGET_AVX512 V inline Xor3(V x, V y, V z) { return _mm512_ternarylogic_epi64(x, y, z, 0x96); }
+SHA512_TARGET_AVX512 V inline Ch(V x, V y, V z) { return _mm512_ternarylogic_epi64(x, y, z, 0xca); }
+SHA512_TARGET_AVX512 V inline Maj(V x, V y, V z) { return _mm512_ternarylogic_epi64(x, y, z, 0xe8); }
+} // namespace
+
+SHA512_TARGET_AVX512 void TransformMulti(uint64_t* const s[], const unsigned char* const chunks[])
+{
+    SHA512_MULTI_TRANSFORM(8);
+}
+} // namespace sha512_avx512
+
+#endif
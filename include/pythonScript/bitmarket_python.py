@@ -7,7 +7,9 @@ if len(sys.argv) != 2 and len(sys.argv) != 4:
 	sys.exit(1)
 
 httpClient = http.client.HTTPSConnection("www.bitmarket.pl")
-outputFile = open("python_json_output", "w")
+
+#response is printed to stdout which the caller reads through a pipe
+outputFile = sys.stdout
 
 #get request
 if len(sys.argv) == 2:
@@ -22,4 +24,4 @@ elif len(sys.argv) == 4:
 	httpClient.request("POST", sys.argv[1], sys.argv[2], headers)
 	outputFile.write( httpClient.getresponse().read().decode("utf-8") )
 
-outputFile.close()
+outputFile.flush()